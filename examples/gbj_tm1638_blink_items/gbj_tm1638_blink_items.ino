@@ -0,0 +1,96 @@
+/*
+  NAME:
+  Demo of blinking selected digital tubes and LEDs with the library gbj_tm1638
+
+  DESCRIPTION:
+  The sketch blinks selected digital tubes and LEDs by the blinking manager of
+  the library without retransmitting the screen buffer.
+  - Connect controller's pins to Arduino's pins as follows:
+    - TM1638 pin CLK to Arduino pin D2
+    - TM1638 pin DIO to Arduino pin D3
+    - TM1638 pin STB to Arduino pin D4
+    - TM1638 pin Vcc to Arduino pin 5V
+    - TM1638 pin GND to Arduino pin GND
+  - The sketch is configured to work with all hardware elements, i.e., 8 digital
+    tubes, 8 red LEDs, and 8 keys.
+  - The sketch blinks every even digital tube and every odd LED for a while,
+    then the entire display module for a while.
+  - The partial blinking sends just affected addresses, the entire module
+    blinking sends just one byte display control command.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_tm1638.h"
+#define SKETCH "GBJ_TM1638_BLINK_ITEMS 1.0.0"
+
+const unsigned int PERIOD_TEST = 5000;  // Time in miliseconds between tests
+const unsigned int PERIOD_BLINK = 300; // Time in miliseconds of a blinking phase
+const unsigned char PIN_TM1638_CLK = 2;
+const unsigned char PIN_TM1638_DIO = 3;
+const unsigned char PIN_TM1638_STB = 4;
+
+gbj_tm1638 Sled = gbj_tm1638(PIN_TM1638_CLK, PIN_TM1638_DIO, PIN_TM1638_STB);
+unsigned long testTimestamp;
+bool testPartial;
+
+
+void errorHandler()
+{
+  if (Sled.isSuccess()) return;
+  Serial.print("Error: ");
+  Serial.println(Sled.getLastResult());
+  Serial.println(Sled.getLastCommand());
+}
+
+
+void blinkTest()
+{
+  Sled.blinkStop();
+  testPartial = !testPartial;
+  if (testPartial)
+  {
+    for (unsigned char i = 0; i < Sled.getDigits(); i += 2) Sled.blinkDigit(i);
+    for (unsigned char i = 1; i < Sled.getLeds(); i += 2) Sled.blinkLed(i);
+  }
+  else
+  {
+    Sled.blinkDigit();
+    Sled.blinkLed();
+  }
+  Sled.blinkStart(PERIOD_BLINK);
+  testTimestamp = millis();
+}
+
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println(SKETCH);
+  Serial.println("Libraries:");
+  Serial.println(gbj_tm1638::VERSION);
+  Serial.println("---");
+  // Initialize controller
+  if (Sled.begin())
+  {
+    errorHandler();
+    return;
+  }
+  Sled.printDigitOn();
+  Sled.printRadixOn();
+  Sled.printLedOnRed();
+  if (Sled.display()) errorHandler();
+  blinkTest();
+}
+
+
+void loop()
+{
+  if (Sled.isError()) return;
+  if (millis() - testTimestamp >= PERIOD_TEST) blinkTest();
+  Sled.run();
+}
@@ -0,0 +1,126 @@
+/*
+  NAME:
+  Benchmark of string printing with the library gbj_tm1638
+
+  DESCRIPTION:
+  The sketch measures the time of writing strings to the screen buffer
+  character by character and by the bulk write method, which translates entire
+  string in one pass, and lists both durations to the serial monitor.
+  - Connect controller's pins to Arduino's pins as follows:
+    - TM1638 pin CLK to Arduino pin D2
+    - TM1638 pin DIO to Arduino pin D3
+    - TM1638 pin STB to Arduino pin D4
+    - TM1638 pin Vcc to Arduino pin 5V
+    - TM1638 pin GND to Arduino pin GND
+  - The sketch is configured to work with all 8 digital tubes with common cathode.
+  - The sketch utilizes basic font.
+  - The controller drives at most 8 digital tubes, so that the 32 characters
+    long string is cut off after the 8th digit, but all its characters are
+    processed by the per character writing.
+  - Measured durations are average times in microseconds of one string writing
+    without transmission to the controller.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_tm1638.h"
+#include "../extras/font7seg_basic.h"
+#define SKETCH "GBJ_TM1638_WRITE_BENCH 1.0.0"
+
+const unsigned int PERIOD_TEST = 5000;  // Time in miliseconds between tests
+const unsigned int TEST_ROUNDS = 1000;
+const unsigned char PIN_TM1638_CLK = 2;
+const unsigned char PIN_TM1638_DIO = 3;
+const unsigned char PIN_TM1638_STB = 4;
+const char* TEXT_SHORT = "8.8.8.8.";
+const char* TEXT_LONG = "1.2.3.4.5.6.7.8.9.A.b.C.d.E.F.0.";
+
+gbj_tm1638 Sled = gbj_tm1638(PIN_TM1638_CLK, PIN_TM1638_DIO, PIN_TM1638_STB);
+
+
+void errorHandler()
+{
+  if (Sled.isSuccess()) return;
+  Serial.print("Error: ");
+  Serial.println(Sled.getLastResult());
+  Serial.println(Sled.getLastCommand());
+}
+
+
+unsigned long benchChars(const char* text)
+{
+  size_t size = strlen(text);
+  unsigned long tsStart = micros();
+  for (unsigned int round = 0; round < TEST_ROUNDS; round++)
+  {
+    Sled.placePrint();
+    for (size_t i = 0; i < size; i++) Sled.write((uint8_t) text[i]);
+  }
+  return (micros() - tsStart) / TEST_ROUNDS;
+}
+
+
+unsigned long benchBulk(const char* text)
+{
+  size_t size = strlen(text);
+  unsigned long tsStart = micros();
+  for (unsigned int round = 0; round < TEST_ROUNDS; round++)
+  {
+    Sled.placePrint();
+    Sled.write((const uint8_t*) text, size);
+  }
+  return (micros() - tsStart) / TEST_ROUNDS;
+}
+
+
+void benchTest(const char* text)
+{
+  unsigned long timeChars = benchChars(text);
+  unsigned long timeBulk = benchBulk(text);
+  Serial.print(strlen(text));
+  Serial.print(" chars: per char ");
+  Serial.print(timeChars);
+  Serial.print(" us, bulk ");
+  Serial.print(timeBulk);
+  Serial.println(" us");
+  if (Sled.display()) errorHandler();
+}
+
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println(SKETCH);
+  Serial.println("Libraries:");
+  Serial.println(gbj_tm1638::VERSION);
+  Serial.println("Fonts:");
+  Serial.println(GBJ_FONT7SEG_VERSION);
+  Serial.println("---");
+  // Initialize controller
+  Sled.begin();
+  if (Sled.isError())
+  {
+    errorHandler();
+    return;
+  }
+
+  Sled.setFont(gbjFont7segTable, sizeof(gbjFont7segTable));
+  if (Sled.isError())
+  {
+    errorHandler();
+    return;
+  }
+}
+
+
+void loop()
+{
+  if (Sled.isError()) return;
+  benchTest(TEXT_SHORT);
+  benchTest(TEXT_LONG);
+  delay(PERIOD_TEST);
+}
@@ -0,0 +1,103 @@
+/*
+  NAME:
+  Host decoder of display mirroring stream of the library gbj_tm1638
+
+  DESCRIPTION:
+  The program applies updates exported by the method mirrorExport() of the
+  library gbj_tm1638 to the image of the screen buffer and renders resulting
+  display state.
+  - The program reads the binary stream from the standard input, e.g.,
+    captured from a serial port dedicated to mirroring.
+  - An update consists of records terminated by the byte 0xFF. A record is
+    the header byte with the start address in the upper nibble and the number
+    of data bytes minus one in the lower nibble, followed by data bytes.
+  - A record exceeding the screen buffer is considered as a corrupted stream
+    and the rest of its update is skipped up to the terminating byte.
+  - With the option -v the program renders the display after every update,
+    otherwise just at the end of the stream.
+  - Finally the program reports the number of updates and average bytes per
+    update.
+  - Compile it on a host, e.g., "g++ -o mirror gbj_tm1638_mirror.cpp".
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include "gbj_tm1638_render.h"
+
+class Tm1638Mirror
+{
+public:
+  uint8_t image[16]; // Screen buffer image
+  uint8_t addr; // Next address of current record
+  uint8_t bytes; // Remaining data bytes of current record
+  bool corrupted; // Flag about skipping rest of an update
+
+  Tm1638Mirror() { memset(this, 0, sizeof(*this)); }
+
+  // Process a stream byte and return flag about finished update
+  bool process(uint8_t data)
+  {
+    if (bytes > 0)
+    {
+      image[addr++] = data;
+      bytes--;
+      return false;
+    }
+    if (data == 0xFF)
+    {
+      bool valid = !corrupted;
+      corrupted = false;
+      return valid;
+    }
+    if (corrupted) return false;
+    addr = data >> 4;
+    bytes = (data & 0x0F) + 1;
+    if (addr + bytes > sizeof(image))
+    {
+      corrupted = true;
+      bytes = 0;
+    }
+    return false;
+  }
+
+  void render()
+  {
+    renderDisplay(image);
+    printf("\n");
+  }
+};
+
+
+int main(int argc, char* argv[])
+{
+  bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  Tm1638Mirror mirror;
+  unsigned long updates = 0, corrupted = 0, bytes = 0;
+  int data;
+  while ((data = getchar()) != EOF)
+  {
+    bytes++;
+    bool wasCorrupted = mirror.corrupted;
+    if (mirror.process(data))
+    {
+      updates++;
+      if (verbose) mirror.render();
+    }
+    else if (!wasCorrupted && mirror.corrupted)
+    {
+      corrupted++;
+    }
+  }
+  if (!verbose) mirror.render();
+  printf("updates: %lu, corrupted: %lu, bytes: %lu", updates, corrupted, bytes);
+  if (updates) printf(", bytes per update: %.1f", (double) bytes / updates);
+  printf("\n");
+  return 0;
+}
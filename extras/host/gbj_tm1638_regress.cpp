@@ -0,0 +1,267 @@
+/*
+  NAME:
+  Host regression tests of the library gbj_tm1638
+
+  DESCRIPTION:
+  The program runs scenarios of the library against the simulated controller
+  TM1638 and compares the resulting display register with the one achieved
+  by a reference scenario, which reaches the same screen buffer
+  straightforwardly.
+  - Every scenario reproduces a combination of features, which once
+    transmitted stale or wrong content.
+  - The program reports every scenario and exits with nonzero code, if some
+    of them fails.
+  - Compile it on a host from this folder, e.g.,
+    "g++ -std=gnu++11 -DESP8266 -Imock -I../../src -o regress
+    gbj_tm1638_regress.cpp mock/tm1638_mock.cpp ../../src/gbj_tm1638.cpp".
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include <cstdio>
+#include <cstring>
+#include "gbj_tm1638.h"
+#include "tm1638_mock.h"
+#include "../font7seg_basic.h"
+
+uint8_t reference[16];
+unsigned long failures;
+
+
+// Objects with static storage are zero initialized at their construction
+void start(gbj_tm1638 &sled)
+{
+  mockReset();
+  sled.begin();
+  sled.setFont(gbjFont7segTable, sizeof(gbjFont7segTable));
+}
+
+
+void runFor(gbj_tm1638 &sled, uint32_t ms)
+{
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    sled.run();
+    mockAdvance(1);
+  }
+}
+
+
+void keepReference()
+{
+  memcpy(reference, mockTm1638.ram, sizeof(reference));
+}
+
+
+bool expect(const char* scenario, bool passed)
+{
+  printf("%s: %s\n", passed ? "PASS" : "FAIL", scenario);
+  if (!passed) failures++;
+  return passed;
+}
+
+
+void check(const char* scenario)
+{
+  if (expect(scenario, memcmp(reference, mockTm1638.ram, sizeof(reference)) == 0)) return;
+  for (uint8_t addr = 0; addr < sizeof(reference); addr++)
+  {
+    printf("  addr %2u: expected 0x%02X, displayed 0x%02X\n", addr, reference[addr], mockTm1638.ram[addr]);
+  }
+}
+
+
+// Refresh must not consume dirty grids, which common anode transposes
+void testAnodeRefresh()
+{
+  static gbj_tm1638 Reference, Sled;
+  start(Reference);
+  Reference.setCommonAnode();
+  Reference.printText("12345678");
+  Reference.printDigit(3, 0x00);
+  Reference.display();
+  keepReference();
+  start(Sled);
+  Sled.setCommonAnode();
+  Sled.printText("12345678");
+  Sled.display();
+  Sled.setRefresh(16);
+  Sled.printDigit(3, 0x00);
+  runFor(Sled, 40);
+  Sled.display();
+  check("common anode with refresh");
+}
+
+
+// Refresh steps must cover the frame enlarged by common anode in the window
+void testAnodeRefreshWindow()
+{
+  static gbj_tm1638 Reference(2, 3, 4, 4, 0), Sled(2, 3, 4, 4, 0);
+  start(Reference);
+  Reference.setCommonAnode();
+  Reference.printText("1234");
+  Reference.display();
+  keepReference();
+  start(Sled);
+  Sled.setRefresh(90);
+  Sled.setCommonAnode();
+  Sled.printText("1234");
+  Sled.display();
+  // Interference corrupting grids
+  for (uint8_t addr = 0; addr < sizeof(mockTm1638.ram); addr += 2) mockTm1638.ram[addr] = 0xFF;
+  runFor(Sled, 100);
+  check("common anode set after refresh window");
+}
+
+
+// Refresh must resend transmitted content only, not drawing without display
+void testRefreshUndisplayed(bool anode)
+{
+  static gbj_tm1638 references[2], sleds[2];
+  gbj_tm1638 &Reference = references[anode], &Sled = sleds[anode];
+  start(Reference);
+  Reference.setCommonAnode(anode);
+  Reference.printText("12345678");
+  Reference.printLedOnRed();
+  Reference.display();
+  keepReference();
+  start(Sled);
+  Sled.setCommonAnode(anode);
+  Sled.printText("12345678");
+  Sled.printLedOnRed();
+  Sled.display();
+  Sled.setRefresh(16);
+  Sled.printText("22222222");
+  Sled.printLedOnGreen();
+  runFor(Sled, 40);
+  check(anode ? "common anode refresh without display" : "refresh without display");
+}
+
+
+// First chunked transmission must respect the time budget of a run
+void testBudgetFirstFrame()
+{
+  static gbj_tm1638 Reference, Sled;
+  start(Reference);
+  Reference.printText("12345678");
+  Reference.printLedOnRed();
+  Reference.display();
+  keepReference();
+  start(Sled);
+  Sled.setBusTiming(gbj_tm1638::BUS_CABLE);
+  Sled.printText("12345678");
+  Sled.printLedOnRed();
+  Sled.displayDefer();
+  for (uint8_t i = 0; i < 100 && Sled.getFramesSent() == 0; i++)
+  {
+    Sled.run(400);
+    mockAdvance(1);
+  }
+  check("budgeted frame transmitted");
+  expect("budgeted frame without overrun", Sled.getRunOverruns() == 0);
+}
+
+
+// First frame must be transmitted at once regardless of the frame period
+void testFramePeriodFirst()
+{
+  static gbj_tm1638 Reference, Sled;
+  start(Reference);
+  Reference.printText("12345678");
+  Reference.display();
+  keepReference();
+  start(Sled);
+  Sled.setFramePeriod(100);
+  Sled.printText("12345678");
+  Sled.display();
+  runFor(Sled, 2);
+  check("first frame with frame period");
+}
+
+
+// Waking from idle suspend must restore display control at suspending
+void testIdleWake()
+{
+  static gbj_tm1638 Sled, Faded;
+  start(Sled);
+  Sled.setContrast(3);
+  Sled.setIdle(1);
+  runFor(Sled, 1100);
+  expect("idle suspend turns display off", Sled.isIdle() && !mockTm1638.on);
+  uint32_t transactions = mockTm1638.transactions;
+  Sled.idleWake();
+  expect("idle wake restores contrast", mockTm1638.on && mockTm1638.contrast == 3);
+  expect("idle wake by frame and one control", mockTm1638.transactions - transactions == 3);
+  Sled.displayOff();
+  runFor(Sled, 1100);
+  mockTm1638.keys[0] = 0x01; // Key S1
+  runFor(Sled, 300);
+  mockTm1638.keys[0] = 0x00;
+  expect("idle wake by key keeps display off", !Sled.isIdle() && !mockTm1638.on);
+  start(Faded);
+  Faded.setIdle(1);
+  Faded.fadeOut(100);
+  runFor(Faded, 1100);
+  Faded.idleWake();
+  expect("idle wake keeps display faded out", !mockTm1638.on);
+}
+
+
+char handled; // Recently called key handler
+
+
+void handlerPlain(uint8_t, uint8_t) { handled = 'p'; }
+void handlerAll(gbj_tm1638*, uint8_t, uint8_t, void* context) { handled = *(char*) context; }
+
+
+// Click is recognized after a long release
+void click(gbj_tm1638 &sled, uint8_t key)
+{
+  runFor(sled, 300);
+  handled = '-';
+  mockTm1638.keys[key % 4] = 0x01 << (key / 4 * 4);
+  runFor(sled, 100);
+  mockTm1638.keys[key % 4] = 0x00;
+  runFor(sled, 400);
+}
+
+
+// Key actions are dispatched by the most specific registration
+void testDispatch()
+{
+  static gbj_tm1638 Sled;
+  static char contextAll = 'a', contextKey = 'k';
+  start(Sled);
+  Sled.registerHandler(handlerPlain);
+  Sled.registerHandler(handlerAll, &contextAll);
+  Sled.registerHandler(1, gbj_tm1638::KEY_CLICK, handlerAll, &contextKey);
+  click(Sled, 0);
+  expect("dispatch for all keys", handled == 'a');
+  click(Sled, 1);
+  expect("dispatch for key and action", handled == 'k');
+  Sled.registerHandler(1, gbj_tm1638::KEY_CLICK, NULL);
+  click(Sled, 1);
+  expect("dispatch to plain handler for removed key", handled == 'p');
+  Sled.registerHandler((gbj_tm1638_dispatcher) NULL, NULL);
+  Sled.registerHandler(NULL);
+  click(Sled, 0);
+  expect("no dispatch after unregistering", handled == '-');
+}
+
+
+int main()
+{
+  testAnodeRefresh();
+  testAnodeRefreshWindow();
+  testRefreshUndisplayed(false);
+  testRefreshUndisplayed(true);
+  testBudgetFirstFrame();
+  testFramePeriodFirst();
+  testIdleWake();
+  testDispatch();
+  return failures > 0;
+}
@@ -0,0 +1,58 @@
+/*
+  NAME:
+  Host rendering of display register content of the controller TM1638
+
+  DESCRIPTION:
+  The function renders the digital tubes as 7-segment glyphs in 3 text rows
+  and the LEDs in one text row from the image of the display register, which
+  is laid out like the one of the controller TM1638 driven by the library
+  gbj_tm1638, i.e., even addresses are grids and odd ones are LEDs.
+  - The header is shared by host decoders, so that they render the same way.
+  - The turned off display is rendered blank.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#ifndef GBJ_TM1638_RENDER_H
+#define GBJ_TM1638_RENDER_H
+
+#include <cstdio>
+#include <stdint.h>
+
+inline void renderDisplay(const uint8_t* ram, bool on = true)
+{
+  // Digital tubes in 3 rows
+  for (uint8_t row = 0; row < 3; row++)
+  {
+    for (uint8_t digit = 0; digit < 8; digit++)
+    {
+      uint8_t mask = on ? ram[2 * digit] : 0;
+      switch (row)
+      {
+        case 0:
+          printf(" %c  ", mask & 0x01 ? '_' : ' ');
+          break;
+        case 1:
+          printf("%c%c%c ", mask & 0x20 ? '|' : ' ', mask & 0x40 ? '_' : ' ', mask & 0x02 ? '|' : ' ');
+          break;
+        case 2:
+          printf("%c%c%c%c", mask & 0x10 ? '|' : ' ', mask & 0x08 ? '_' : ' ', mask & 0x04 ? '|' : ' ', mask & 0x80 ? '.' : ' ');
+          break;
+      }
+    }
+    printf("\n");
+  }
+  // LEDs
+  for (uint8_t led = 0; led < 8; led++)
+  {
+    uint8_t mask = on ? ram[2 * led + 1] & 0x03 : 0;
+    printf(" %c  ", mask == 0x01 ? 'R' : mask == 0x02 ? 'G' : mask ? 'Y' : 'o');
+  }
+  printf("\n");
+}
+
+#endif
@@ -0,0 +1,85 @@
+#!/bin/sh
+#
+# NAME:
+# Flash and SRAM footprint report of the library gbj_tm1638
+#
+# DESCRIPTION:
+# The script compiles the probe sketch gbj_tm1638_size for a reference board
+# in every feature configuration of the library and reports used flash and
+# static SRAM of the library, i.e., above the footprint of the platform core,
+# and savings of each configuration against the full library.
+# - It requires arduino-cli with installed core of the board.
+# - The first argument is the fully qualified board name, default is Arduino
+#   Uno with ATmega328P.
+# - Feature switches are passed to both the sketch and the library by the
+#   build property compiler.cpp.extra_flags together with the include path
+#   of fonts in the folder extras.
+# - Run it before and after a change and compare reports in the review.
+#
+# LICENSE:
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the MIT License (MIT).
+#
+# CREDENTIALS:
+# Author: Libor Gabaj
+#
+FQBN=${1:-arduino:avr:uno}
+HOST=$(cd "$(dirname "$0")" && pwd)
+LIBRARY=$(cd "$HOST/../.." && pwd)
+SKETCH="$HOST/gbj_tm1638_size"
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+
+# Print flash and SRAM of the sketch compiled with flags
+measure()
+{
+  arduino-cli compile --fqbn "$FQBN" --library "$LIBRARY" \
+    --build-path "$BUILD/$1" \
+    --build-property "compiler.cpp.extra_flags=-I$LIBRARY/extras $2" \
+    "$SKETCH" > "$BUILD/$1.log" 2>&1 || { cat "$BUILD/$1.log" >&2; return; }
+  flash=$(sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p' "$BUILD/$1.log")
+  sram=$(sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p' "$BUILD/$1.log")
+  echo "$flash $sram"
+}
+
+set -- $(measure base "-DGBJ_TM1638_SIZE_BASE")
+[ -n "$2" ] || exit 1
+BASE_FLASH=$1
+BASE_SRAM=$2
+FULL_FLASH=0
+FULL_SRAM=0
+
+echo "Board $FQBN, core flash $BASE_FLASH B, core SRAM $BASE_SRAM B"
+printf "%-14s %8s %8s %8s %8s\n" "Configuration" "Flash" "SRAM" "-Flash" "-SRAM"
+while read -r NAME FLAGS
+do
+  set -- $(measure "$NAME" "$FLAGS")
+  [ -n "$2" ] || exit 1
+  FLASH=$(($1 - BASE_FLASH))
+  SRAM=$(($2 - BASE_SRAM))
+  if [ "$NAME" = "full" ]
+  then
+    FULL_FLASH=$FLASH
+    FULL_SRAM=$SRAM
+  fi
+  printf "%-14s %8d %8d %8d %8d\n" "$NAME" "$FLASH" "$SRAM" \
+    $((FULL_FLASH - FLASH)) $((FULL_SRAM - SRAM))
+done <<CONFIGS
+full
+no-keypad -DGBJ_TM1638_KEYPAD=0
+no-print -DGBJ_TM1638_PRINT=0
+no-leds -DGBJ_TM1638_LEDS=0
+no-animation -DGBJ_TM1638_ANIMATION=0
+no-anode -DGBJ_TM1638_ANODE=0
+no-refresh -DGBJ_TM1638_REFRESH=0
+no-idle -DGBJ_TM1638_IDLE=0
+no-mirror -DGBJ_TM1638_MIRROR=0
+no-scheduler -DGBJ_TM1638_SCHEDULER=0
+no-bus-timing -DGBJ_TM1638_BUS_TIMING=0
+no-latency -DGBJ_TM1638_LATENCY_BINS=0
+no-dispatch -DGBJ_TM1638_DISPATCHERS=0
+no-fields -DGBJ_TM1638_FIELDS=0
+one-page -DGBJ_TM1638_PAGES=1
+display-only -DGBJ_TM1638_KEYPAD=0 -DGBJ_TM1638_PRINT=0 -DGBJ_TM1638_LEDS=0 -DGBJ_TM1638_ANIMATION=0
+minimal -DGBJ_TM1638_KEYPAD=0 -DGBJ_TM1638_PRINT=0 -DGBJ_TM1638_LEDS=0 -DGBJ_TM1638_ANIMATION=0 -DGBJ_TM1638_ANODE=0 -DGBJ_TM1638_REFRESH=0 -DGBJ_TM1638_IDLE=0 -DGBJ_TM1638_MIRROR=0 -DGBJ_TM1638_SCHEDULER=0 -DGBJ_TM1638_BUS_TIMING=0 -DGBJ_TM1638_PAGES=1
+CONFIGS
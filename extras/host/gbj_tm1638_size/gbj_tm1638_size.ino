@@ -0,0 +1,119 @@
+/*
+  NAME:
+  Footprint probe of the library gbj_tm1638
+
+  DESCRIPTION:
+  The sketch uses every feature of the library, which is included in the build,
+  so that the linker keeps its code. It is compiled by the script
+  gbj_tm1638_size.sh for each feature configuration and is not intended for
+  running on a display module.
+  - With the macro GBJ_TM1638_SIZE_BASE the sketch does not use the library at
+    all, so that it measures the footprint of the platform core.
+  - The font is included from the folder extras of the library, which the
+    script adds to the include path.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_tm1638.h"
+#include "font7seg_basic.h"
+
+#ifndef GBJ_TM1638_SIZE_BASE
+gbj_tm1638 Sled = gbj_tm1638(2, 3, 4);
+
+#if GBJ_TM1638_KEYPAD
+void keyHandler(uint8_t key, uint8_t action)
+{
+  Sled.printDigit(key, action);
+}
+#if GBJ_TM1638_DISPATCHERS
+void keyDispatcher(gbj_tm1638* sled, uint8_t key, uint8_t action, void* context)
+{
+  sled->printDigit(key, action | *(uint8_t*) context);
+}
+uint8_t keyContext = 0x80;
+#endif
+#endif
+
+#if GBJ_TM1638_MIRROR
+// Stream discarding the export, so that no serial port is linked
+class Sink : public Print
+{
+public:
+  size_t write(uint8_t) { return 1; }
+} sink;
+#endif
+
+#if GBJ_TM1638_ANIMATION
+void animation()
+{
+  Sled.printRadixToggle(0);
+}
+#endif
+#endif
+
+
+void setup()
+{
+#ifndef GBJ_TM1638_SIZE_BASE
+  Sled.begin();
+  Sled.printDigit(0, 0x3F);
+#if GBJ_TM1638_PRINT
+  Sled.setFont(gbjFont7segTable, sizeof(gbjFont7segTable));
+  Sled.print("12.34");
+#if GBJ_TM1638_FIELDS
+  Sled.fieldBegin(0, 4, 4);
+  Sled.fieldPrint(0, 12.5f);
+#endif
+#endif
+#if GBJ_TM1638_LEDS
+  Sled.printLedBar(3);
+#endif
+#if GBJ_TM1638_KEYPAD
+  Sled.registerHandler(keyHandler);
+#if GBJ_TM1638_DISPATCHERS
+  Sled.registerHandler(0, gbj_tm1638::KEY_HOLD, keyDispatcher, &keyContext);
+#endif
+#endif
+#if GBJ_TM1638_ANIMATION
+  Sled.registerAnimation(animation, 500);
+  Sled.blinkDigit(0);
+  Sled.blinkStart();
+  Sled.fadeIn();
+#endif
+#if GBJ_TM1638_ANODE
+  Sled.setCommonAnode();
+#endif
+#if GBJ_TM1638_BUS_TIMING
+  Sled.setBusTiming();
+#endif
+#if GBJ_TM1638_REFRESH
+  Sled.setRefresh();
+#endif
+#if GBJ_TM1638_IDLE
+  Sled.setIdle(60);
+#endif
+#if GBJ_TM1638_SCHEDULER
+  Sled.setFramePeriod(17);
+#endif
+  Sled.display();
+#endif
+}
+
+
+void loop()
+{
+#ifndef GBJ_TM1638_SIZE_BASE
+  Sled.run(500);
+#if GBJ_TM1638_KEYPAD && GBJ_TM1638_LATENCY_BINS
+  if (Sled.getKeyLatency(gbj_tm1638::KEY_CLICK, 0)) Sled.resetKeyLatency();
+#endif
+#if GBJ_TM1638_MIRROR
+  Sled.mirrorExport(sink);
+#endif
+#endif
+}
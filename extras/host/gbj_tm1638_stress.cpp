@@ -0,0 +1,91 @@
+/*
+  NAME:
+  Host stress test of the shared screen of the library gbj_tm1638
+
+  DESCRIPTION:
+  The program runs the library against the simulated controller TM1638 with
+  the shared screen, where a drawer thread publishes screen buffers and
+  a renderer thread runs the scheduler like the refresh task from the method
+  taskBegin() does, and checks the display register for torn frames.
+  - Every published screen buffer has all digital tubes and all LEDs with
+    the same content, so that the display register with different digital
+    tubes or LEDs after a run is a torn frame.
+  - The drawer never waits for the renderer, which postpones taking of the
+    screen buffer published in the meantime.
+  - The program exits with nonzero code, if some torn frame is detected or
+    no frame has been transmitted.
+  - Compile it on a host from this folder, e.g.,
+    "g++ -std=gnu++11 -pthread -DESP8266 -DGBJ_TM1638_CONCURRENT=1 -Imock
+    -I../../src -o stress gbj_tm1638_stress.cpp mock/tm1638_mock.cpp
+    ../../src/gbj_tm1638.cpp".
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "gbj_tm1638.h"
+#include "tm1638_mock.h"
+
+#if !GBJ_TM1638_CONCURRENT
+  #error "Compile with GBJ_TM1638_CONCURRENT=1"
+#endif
+
+gbj_tm1638 Sled;
+
+
+// Check that all digital tubes and all LEDs are equal in display register
+bool frameTorn()
+{
+  for (uint8_t addr = 2; addr < 16; addr++)
+  {
+    if (mockTm1638.ram[addr] != mockTm1638.ram[addr % 2]) return true;
+  }
+  return false;
+}
+
+
+int main(int argc, char* argv[])
+{
+  unsigned long publishes = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+  mockReset();
+  if (Sled.begin()) return 1;
+  Sled.shareBegin();
+  std::atomic<bool> finished(false);
+  std::thread drawer([&]()
+  {
+    for (unsigned long i = 0; i < publishes; i++)
+    {
+      uint8_t pattern = i % 0x7F + 1;
+      Sled.printDigit(pattern);
+      for (uint8_t led = 0; led < Sled.getLeds(); led++) Sled.printLedOff(led);
+      if (i & 1) Sled.printLedOnRed();
+      Sled.publish();
+    }
+    finished = true;
+  });
+  unsigned long runs = 0, torn = 0;
+  uint8_t recent = mockTm1638.ram[0];
+  unsigned long changes = 0;
+  while (!finished)
+  {
+    Sled.run();
+    runs++;
+    if (frameTorn()) torn++;
+    if (mockTm1638.ram[0] != recent)
+    {
+      recent = mockTm1638.ram[0];
+      changes++;
+    }
+  }
+  drawer.join();
+  printf("publishes: %lu, runs: %lu, displayed changes: %lu, postponed takings: %lu, torn frames: %lu\n",
+    publishes, runs, changes, (unsigned long) Sled.getShareRetries(), torn);
+  return torn > 0 || changes == 0;
+}
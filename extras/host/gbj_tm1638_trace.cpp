@@ -0,0 +1,124 @@
+/*
+  NAME:
+  Host decoder of bus transactions trace of the library gbj_tm1638
+
+  DESCRIPTION:
+  The program replays a trace of bus transactions dumped by the method
+  traceDump() of the library gbj_tm1638 into a simple simulator of the
+  controller TM1638 and renders resulting display state and keypad reads.
+  - The program reads the dump from the standard input. Lines not starting with
+    the trace mark "T " are ignored, so that the entire serial monitor output
+    can be used.
+  - With the option -v the program renders the display after every transaction
+    changing it, otherwise just at the end of the trace.
+  - Finally the program reports the number of transactions and the achieved
+    bit rate on the bus computed from transactions' durations.
+  - Compile it on a host, e.g., "g++ -o trace gbj_tm1638_trace.cpp".
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include "gbj_tm1638_render.h"
+
+class Tm1638Sim
+{
+public:
+  uint8_t ram[16]; // Display register
+  uint8_t keys[4]; // Recently read key scanning data
+  uint8_t address; // Current display address
+  bool fixed; // Fixed address mode
+  bool test; // Test mode
+  bool on; // Display is on
+  uint8_t contrast; // Display contrast
+
+  Tm1638Sim() { memset(this, 0, sizeof(*this)); }
+
+  // Process a transaction and return flag about display change
+  bool transaction(uint8_t command, const uint8_t* payload, uint8_t bytes)
+  {
+    switch (command & 0xC0)
+    {
+      case 0x40: // Data command
+        fixed = command & 0x04;
+        test = command & 0x08;
+        if (command & 0x02) memcpy(keys, payload, bytes < 4 ? bytes : 4);
+        return false;
+
+      case 0x80: // Display control
+        on = command & 0x08;
+        contrast = command & 0x07;
+        return true;
+
+      case 0xC0: // Address command with data
+        address = command & 0x0F;
+        for (uint8_t i = 0; i < bytes; i++)
+        {
+          ram[address] = payload[i];
+          if (!fixed) address = (address + 1) & 0x0F;
+        }
+        return bytes > 0;
+    }
+    return false;
+  }
+
+  void render()
+  {
+    renderDisplay(ram, on);
+    printf("display %s, contrast %u\n", on ? "on" : "off", contrast);
+    // Keys on lines K3, K2, K1
+    printf("keys pressed:");
+    for (uint8_t line = 0; line < 3; line++)
+    {
+      for (uint8_t scanByte = 0; scanByte < 4; scanByte++)
+      {
+        if (keys[scanByte] & (0x01 << line)) printf(" S%u", 8 * line + scanByte + 1);
+        if (keys[scanByte] & (0x10 << line)) printf(" S%u", 8 * line + scanByte + 5);
+      }
+    }
+    printf("\n\n");
+  }
+};
+
+
+int main(int argc, char* argv[])
+{
+  bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  Tm1638Sim sim;
+  char line[256];
+  unsigned long transactions = 0, bits = 0, duration = 0;
+  while (fgets(line, sizeof(line), stdin))
+  {
+    if (strncmp(line, "T ", 2) != 0) continue;
+    char* cursor = line + 2;
+    strtoul(cursor, &cursor, 10); // Timestamp
+    unsigned long us = strtoul(cursor, &cursor, 10);
+    uint8_t command = strtoul(cursor, &cursor, 16);
+    uint8_t payload[16];
+    uint8_t bytes = 0;
+    char* next;
+    while (bytes < sizeof(payload))
+    {
+      unsigned long value = strtoul(cursor, &next, 16);
+      if (next == cursor) break;
+      payload[bytes++] = value;
+      cursor = next;
+    }
+    transactions++;
+    bits += 8 * (1 + bytes);
+    duration += us;
+    if (sim.transaction(command, payload, bytes) && verbose) sim.render();
+  }
+  if (!verbose) sim.render();
+  printf("transactions: %lu, bytes: %lu, bus time: %lu us", transactions, bits / 8, duration);
+  if (duration) printf(", bit rate: %lu kbit/s", bits * 1000 / duration);
+  printf("\n");
+  return 0;
+}
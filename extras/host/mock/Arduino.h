@@ -0,0 +1,99 @@
+/*
+  NAME:
+  Mock of the Arduino core for host programs of the library gbj_tm1638
+
+  DESCRIPTION:
+  The header provides the subset of the Arduino API used by the library, so
+  that the library can be compiled and run on a host against the simulated
+  controller TM1638 in tm1638_mock.cpp.
+  - Compile the library with this folder in the include path and with
+    the macro ESP8266, e.g., "-DESP8266 -Iextras/host/mock -Isrc".
+  - The functions min() and max() are templates like on ESP32, so that mixed
+    argument types are detected on a host already.
+  - Time is virtual. It runs only by delays and by the function mockAdvance().
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#ifndef ARDUINO_MOCK_H
+#define ARDUINO_MOCK_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+using std::min;
+using std::max;
+
+class String
+{
+public:
+  String(const char* text = "") : text_(text) {}
+  const char* c_str() const { return text_.c_str(); }
+  unsigned int length() const { return text_.length(); }
+private:
+  std::string text_;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t data) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* text) { return text ? write((const uint8_t*) text, strlen(text)) : 0; }
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char data) { return write((uint8_t) data); }
+  size_t print(unsigned long number, int base = DEC) { return printNumber(number, base); }
+  size_t print(long number, int base = DEC)
+  {
+    if (number < 0 && base == DEC) return print('-') + printNumber(-(unsigned long) number, base);
+    return printNumber(number, base);
+  }
+  size_t print(int number, int base = DEC) { return print((long) number, base); }
+  size_t print(unsigned int number, int base = DEC) { return print((unsigned long) number, base); }
+  size_t print(unsigned char number, int base = DEC) { return print((unsigned long) number, base); }
+  size_t println() { return write("\r\n"); }
+  template<typename T> size_t println(T data) { return print(data) + println(); }
+  template<typename T> size_t println(T data, int base) { return print(data, base) + println(); }
+private:
+  size_t printNumber(unsigned long number, int base)
+  {
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", number);
+    return write(text);
+  }
+};
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint32_t millis();
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+#endif
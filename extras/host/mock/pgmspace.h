@@ -0,0 +1,2 @@
+// Program memory is the operating memory on a host, see Arduino.h
+#include "Arduino.h"
@@ -0,0 +1,138 @@
+/*
+  NAME:
+  Simulated controller TM1638 on the mocked pins of the Arduino core
+
+  DESCRIPTION:
+  See tm1638_mock.h.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "Arduino.h"
+#include "tm1638_mock.h"
+#include <atomic>
+
+Tm1638Mock mockTm1638;
+
+static std::atomic<uint32_t> timeMicros(0);
+static struct
+{
+  uint8_t pinClk = 2, pinDio = 3, pinStb = 4;
+  uint8_t clk = HIGH, dio = HIGH, stb = HIGH;
+  bool input; // DIO is input of the microcontroller
+  bool fixed; // Fixed addressing
+  bool reading; // Reading of key scanning data
+  uint8_t command; // First byte of transaction
+  uint8_t address; // Current display address
+  uint8_t bytes; // Received bytes in transaction
+  uint8_t data; // Received bits
+  uint8_t bits; // Number of received or sent bits
+} bus;
+
+
+// Bytes of a transaction are executed as they are received
+static void execute(uint8_t data)
+{
+  mockTm1638.bytes++;
+  if (bus.bytes++ == 0)
+  {
+    bus.command = data;
+    switch (data & 0xC0)
+    {
+      case 0x40: // Data command
+        bus.fixed = data & 0x04;
+        bus.reading = data & 0x02;
+        break;
+      case 0x80: // Display control
+        mockTm1638.on = data & 0x08;
+        mockTm1638.contrast = data & 0x07;
+        break;
+      case 0xC0: // Address command
+        bus.address = data & 0x0F;
+        break;
+    }
+    return;
+  }
+  if ((bus.command & 0xC0) != 0xC0) return;
+  mockTm1638.ram[bus.address] = data;
+  if (!bus.fixed) bus.address = (bus.address + 1) & 0x0F;
+}
+
+
+void mockPins(uint8_t pinClk, uint8_t pinDio, uint8_t pinStb)
+{
+  bus.pinClk = pinClk;
+  bus.pinDio = pinDio;
+  bus.pinStb = pinStb;
+}
+
+
+void mockReset()
+{
+  memset(&mockTm1638, 0, sizeof(mockTm1638));
+  timeMicros = 0;
+}
+
+
+void mockAdvance(uint32_t ms)
+{
+  timeMicros += 1000 * ms;
+}
+
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin == bus.pinDio) bus.input = mode == INPUT;
+}
+
+
+// Bits are sampled at rising edge of clock while strobe is active
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  value = value ? HIGH : LOW;
+  if (pin == bus.pinStb)
+  {
+    if (value == LOW && bus.stb == HIGH) bus.bytes = bus.bits = 0;
+    if (value == HIGH && bus.stb == LOW && bus.bytes) mockTm1638.transactions++;
+    bus.stb = value;
+  }
+  else if (pin == bus.pinDio)
+  {
+    bus.dio = value;
+  }
+  else if (pin == bus.pinClk)
+  {
+    if (value == HIGH && bus.clk == LOW && bus.stb == LOW && !bus.input)
+    {
+      bus.data = (bus.data >> 1) | (bus.dio << 7);
+      if (++bus.bits == 8)
+      {
+        bus.bits = 0;
+        execute(bus.data);
+      }
+    }
+    bus.clk = value;
+  }
+}
+
+
+// Key scanning data are output bit by bit in reading order of the library
+int digitalRead(uint8_t pin)
+{
+  if (pin != bus.pinDio || !bus.input || !bus.reading) return HIGH;
+  uint8_t index = (bus.bits / 8) & 0x03;
+  int level = (mockTm1638.keys[index] >> (bus.bits % 8)) & 1;
+  bus.bits = (bus.bits + 1) % 32;
+  return level;
+}
+
+
+uint32_t millis() { return timeMicros / 1000; }
+uint32_t micros() { return timeMicros; }
+void delay(unsigned long ms) { mockAdvance(ms); }
+void delayMicroseconds(unsigned int us) { timeMicros += us; }
+void yield() {}
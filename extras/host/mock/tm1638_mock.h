@@ -0,0 +1,42 @@
+/*
+  NAME:
+  Simulated controller TM1638 on the mocked pins of the Arduino core
+
+  DESCRIPTION:
+  The simulator decodes bit-banged transactions on pins CLK, DIO, and STB
+  at levels set by the library and executes them like the controller, i.e.,
+  it updates the display register and display control and serves key
+  scanning data at reading.
+  - Default pins are the default ones of the library's constructor.
+  - Bus access is not thread safe. The simulator is intended for one thread
+    communicating with the controller.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#ifndef TM1638_MOCK_H
+#define TM1638_MOCK_H
+
+#include <stdint.h>
+
+struct Tm1638Mock
+{
+  uint8_t ram[16]; // Display register
+  uint8_t keys[4]; // Key scanning data served at reading
+  bool on; // Display is on
+  uint8_t contrast; // Display contrast
+  uint32_t transactions; // Number of finished transactions
+  uint32_t bytes; // Number of transferred bytes
+};
+
+extern Tm1638Mock mockTm1638;
+
+void mockPins(uint8_t pinClk, uint8_t pinDio, uint8_t pinStb); // Assign pins
+void mockReset(); // Clear controller state and virtual time
+void mockAdvance(uint32_t ms); // Advance virtual time
+
+#endif
@@ -1,5 +1,42 @@
 #include "gbj_tm1638.h"
-const String gbj_tm1638::VERSION = "GBJ_TM1638 1.0.0";
+const char* const gbj_tm1638::VERSION = "GBJ_TM1638 1.0.0";
+
+// Segment masks remapping for orientations other than normal one
+static const uint8_t orientationTable[2][128] PROGMEM =
+{
+  // Rotated by 180 degrees: A<->D, B<->E, C<->F
+  {
+  0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38, 0x01, 0x09, 0x11, 0x19, 0x21, 0x29, 0x31, 0x39,
+  0x02, 0x0A, 0x12, 0x1A, 0x22, 0x2A, 0x32, 0x3A, 0x03, 0x0B, 0x13, 0x1B, 0x23, 0x2B, 0x33, 0x3B,
+  0x04, 0x0C, 0x14, 0x1C, 0x24, 0x2C, 0x34, 0x3C, 0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x35, 0x3D,
+  0x06, 0x0E, 0x16, 0x1E, 0x26, 0x2E, 0x36, 0x3E, 0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F,
+  0x40, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78, 0x41, 0x49, 0x51, 0x59, 0x61, 0x69, 0x71, 0x79,
+  0x42, 0x4A, 0x52, 0x5A, 0x62, 0x6A, 0x72, 0x7A, 0x43, 0x4B, 0x53, 0x5B, 0x63, 0x6B, 0x73, 0x7B,
+  0x44, 0x4C, 0x54, 0x5C, 0x64, 0x6C, 0x74, 0x7C, 0x45, 0x4D, 0x55, 0x5D, 0x65, 0x6D, 0x75, 0x7D,
+  0x46, 0x4E, 0x56, 0x5E, 0x66, 0x6E, 0x76, 0x7E, 0x47, 0x4F, 0x57, 0x5F, 0x67, 0x6F, 0x77, 0x7F
+  },
+  // Mirrored: B<->F, C<->E
+  {
+  0x00, 0x01, 0x20, 0x21, 0x10, 0x11, 0x30, 0x31, 0x08, 0x09, 0x28, 0x29, 0x18, 0x19, 0x38, 0x39,
+  0x04, 0x05, 0x24, 0x25, 0x14, 0x15, 0x34, 0x35, 0x0C, 0x0D, 0x2C, 0x2D, 0x1C, 0x1D, 0x3C, 0x3D,
+  0x02, 0x03, 0x22, 0x23, 0x12, 0x13, 0x32, 0x33, 0x0A, 0x0B, 0x2A, 0x2B, 0x1A, 0x1B, 0x3A, 0x3B,
+  0x06, 0x07, 0x26, 0x27, 0x16, 0x17, 0x36, 0x37, 0x0E, 0x0F, 0x2E, 0x2F, 0x1E, 0x1F, 0x3E, 0x3F,
+  0x40, 0x41, 0x60, 0x61, 0x50, 0x51, 0x70, 0x71, 0x48, 0x49, 0x68, 0x69, 0x58, 0x59, 0x78, 0x79,
+  0x44, 0x45, 0x64, 0x65, 0x54, 0x55, 0x74, 0x75, 0x4C, 0x4D, 0x6C, 0x6D, 0x5C, 0x5D, 0x7C, 0x7D,
+  0x42, 0x43, 0x62, 0x63, 0x52, 0x53, 0x72, 0x73, 0x4A, 0x4B, 0x6A, 0x6B, 0x5A, 0x5B, 0x7A, 0x7B,
+  0x46, 0x47, 0x66, 0x67, 0x56, 0x57, 0x76, 0x77, 0x4E, 0x4F, 0x6E, 0x6F, 0x5E, 0x5F, 0x7E, 0x7F
+  },
+};
+
+#if GBJ_TM1638_BUS_TIMING
+// Clock high, clock low, and strobe setup times in microseconds by profiles
+static const uint8_t busTimingTable[3][3] PROGMEM =
+{
+  {0, 0, 0}, // Fast
+  {1, 1, 1}, // Datasheet
+  {5, 5, 10}, // Cable
+};
+#endif
 
 
 gbj_tm1638::gbj_tm1638(uint8_t pinClk, uint8_t pinDio, uint8_t pinStb, \
@@ -9,13 +46,33 @@ gbj_tm1638::gbj_tm1638(uint8_t pinClk, uint8_t pinDio, uint8_t pinStb, \
   status_.pinDio = pinDio;
   status_.pinStb = pinStb;
   status_.digits = min(digits, getDigitsMax());
+#if GBJ_TM1638_LEDS
   status_.leds = min(leds, getLedsMax());
+#else
+  (void) leds;
+#endif
+#if GBJ_TM1638_KEYPAD
   status_.keys = min(keys, getKeysMaxHw());
+  scan_.actions = true;
+#else
+  (void) keys;
+#endif
+  // Controlled addresses for checking entire display in transmission loops
+  uint16_t addrs = 0;
+  for (uint8_t digit = 0; digit < status_.digits; digit++) addrs |= 1 << addrGrid(digit);
+  for (uint8_t led = 0; led < status_.leds; led++) addrs |= 1 << addrLed(led);
+  status_.addrs = addrs;
+  print_.dirty = 0xFFFF; // Controller's memory is unknown
+  mirrorMark(0xFFFF);
+  print_.buffer = pages_[0].buffer;
+  page_.frame = pages_[0].buffer;
 }
 
 
-uint8_t gbj_tm1638::begin()
+// Result is returned by value, because members differ in sketch's layout
+uint8_t gbj_tm1638::beginConfig(size_t size, uint16_t features)
 {
+  if (size != sizeof(gbj_tm1638) || features != GBJ_TM1638_FEATURES) return ERROR_CONFIG;
   initLastResult();
   // Check pin duplicity
   if (status_.pinClk == status_.pinDio \
@@ -33,6 +90,7 @@ uint8_t gbj_tm1638::begin()
 //------------------------------------------------------------------------------
 // Software manipulation - updating screen buffer
 //------------------------------------------------------------------------------
+#if GBJ_TM1638_PRINT
 // Print one character determined by a byte of ASCII code
 size_t gbj_tm1638::write(uint8_t ascii)
 {
@@ -40,7 +98,7 @@ size_t gbj_tm1638::write(uint8_t ascii)
   uint8_t mask = getFontMask(ascii);
   if (mask == FONT_MASK_WRONG)
   {
-    if (String(".,:").indexOf(ascii) >= 0)  // Detect radix
+    if (ascii == '.' || ascii == ',' || ascii == ':')  // Detect radix
     {
       printRadixOn(print_.digit - 1); // Set radix to the previous digit
     }
@@ -57,26 +115,21 @@ size_t gbj_tm1638::write(uint8_t ascii)
 // Print null terminated character array
 size_t  gbj_tm1638::write(const char* text)
 {
-  uint8_t digits = 0;
-  uint8_t i = 0;
-  while (text[i] != '\0' && print_.digit < status_.digits)
-  {
-    digits += write(text[i++]);
-  }
-  return digits;
+  if (text == NULL) return 0;
+  return write((const uint8_t*) text, strlen(text));
 }
 
 
-// Print byte array with length
+// Print byte array with length translated in one pass to the digits
 size_t  gbj_tm1638::write(const uint8_t* buffer, size_t size)
 {
-  uint8_t digits = 0;
-  for (uint8_t i = 0; i < size && print_.digit < status_.digits; i++)
-  {
-    digits += write(buffer[i]);
-  }
+  uint8_t masks[DIGITS];
+  for (uint8_t i = 0; i < status_.digits; i++) masks[i] = print_.buffer[addrGrid(i)];
+  uint8_t digits = textMasks(buffer, size, masks, print_.digit, status_.digits);
+  for (uint8_t i = 0; i < status_.digits; i++) bufferSet(addrGrid(i), masks[i]);
   return digits;
 }
+#endif
 
 
 //------------------------------------------------------------------------------
@@ -84,12 +137,39 @@ size_t  gbj_tm1638::write(const uint8_t* buffer, size_t size)
 //------------------------------------------------------------------------------
 uint8_t gbj_tm1638::display()
 {
-  // Needed bytes in the buffer
-  uint8_t bufferLen = max(getDigits(), getLeds()) * 2;
-  if (getDigits() > getLeds()) bufferLen--;
-  // Automatic addressing
-  if (busSend(CMD_DATA_INIT | CMD_DATA_NORMAL | CMD_DATA_WRITE | CMD_DATA_AUTO)) return getLastResult();
-  if (busSend(CMD_ADDR_INIT, print_.buffer, bufferLen)) return getLastResult();
+#if GBJ_TM1638_SCHEDULER
+  if (frame_.period > 0)
+  {
+    displayDefer();
+    return getLastResult();
+  }
+#endif
+  return displayNow();
+}
+
+
+// Transmission during idle suspend is postponed to waking
+uint8_t gbj_tm1638::displayNow()
+{
+  if (idleActive())
+  {
+    displayDefer();
+    return getLastResult();
+  }
+  frame_.pending = false;
+#if GBJ_TM1638_SCHEDULER
+  if (frame_.requested < 0xFFFFFFFF) frame_.requested++;
+  frame_.active = false;
+  frame_.started = true;
+  frame_.timestamp = millis();
+#endif
+#if GBJ_TM1638_ANODE
+  if (status_.anode) anodeUpdate(false);
+#endif
+  if (busSendFrame(0, frameBytes())) return getLastResult();
+#if GBJ_TM1638_SCHEDULER
+  if (frame_.sent < 0xFFFFFFFF) frame_.sent++;
+#endif
   return getLastResult();
 }
 
@@ -100,65 +180,815 @@ uint8_t gbj_tm1638::displayOn()
 }
 
 
+// Display control during idle suspend is restored at waking
 uint8_t gbj_tm1638::displayOff()
 {
+#if GBJ_TM1638_IDLE
+  if (idle_.active)
+  {
+    idle_.control = CMD_DISP_INIT | CMD_DISP_OFF;
+    return getLastResult();
+  }
+#endif
   return busSend(CMD_DISP_INIT | CMD_DISP_OFF);
 }
 
 
+void gbj_tm1638::pageDraw(uint8_t page)
+{
+  if (page >= getPages()) return;
+  pages_[page_.draw].digit = print_.digit;
+  page_.draw = page;
+  print_.buffer = pages_[page].buffer;
+  print_.digit = pages_[page].digit;
+}
+
+
+uint8_t gbj_tm1638::pageShow(uint8_t page)
+{
+  if (page >= getPages()) return getLastResult();
+  page_.show = page;
+  page_.frame = pages_[page].buffer;
+  print_.dirty = 0xFFFF;
+  mirrorMark(0xFFFF);
+  return display();
+}
+
+
+uint8_t gbj_tm1638::pageShow_P(const uint8_t* frame)
+{
+  page_.show = getPages();
+  page_.frame = frame;
+  print_.dirty = 0xFFFF;
+  mirrorMark(0xFFFF);
+  return display();
+}
+
+
+#if GBJ_TM1638_IDLE
+// Display is off since suspending, so that only turned on state is sent
+uint8_t gbj_tm1638::idleWake()
+{
+  idle_.timestamp = millis();
+  if (!idle_.active) return getLastResult();
+  idle_.active = false;
+  if (displayNow()) return getLastResult();
+  if (!(idle_.control & CMD_DISP_ON)) return getLastResult();
+  return busSend(idle_.control);
+}
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+uint8_t gbj_tm1638::blinkStop()
+{
+  blink_.active = false;
+  if (blink_.off)
+  {
+    blink_.off = false;
+    if (blink_.mask == addrMask())
+    {
+      displayOn();
+    }
+    else
+    {
+      busSendFixed(anodeMask(blink_.mask));
+    }
+  }
+  blink_.mask = 0;
+  return getLastResult();
+}
+
+
+uint8_t gbj_tm1638::fadeStop()
+{
+  fade_.active = false;
+  return displayOn();
+}
+#endif
+
+
+#if GBJ_TM1638_LEDS
+uint8_t gbj_tm1638::printLedBar(uint8_t level, uint8_t colorZones)
+{
+  level = min(level, status_.leds);
+  uint8_t pattern = (1 << level) - 1; // Lit LEDs
+  // Peak holding and decay
+  if (bar_.decay > 0)
+  {
+    uint32_t tsNow = millis();
+    if (level >= bar_.peak)
+    {
+      bar_.peak = level;
+      bar_.timestamp = tsNow;
+    }
+    while (bar_.peak > level && tsNow - bar_.timestamp >= (uint32_t) bar_.hold + bar_.decay)
+    {
+      bar_.peak--;
+      bar_.timestamp += bar_.decay;
+    }
+    if (bar_.peak > level) pattern |= 1 << (bar_.peak - 1);
+  }
+  // Update changed LEDs
+  uint16_t mask = 0;
+  for (uint8_t led = 0; led < status_.leds; led++)
+  {
+    uint8_t data = LED_OFF;
+    if (pattern & (1 << led)) data = colorZones & (1 << led) ? LED_RED : LED_GREEN;
+    if (print_.buffer[addrLed(led)] == data) continue;
+    bufferSet(addrLed(led), data);
+    mask |= 1 << addrLed(led);
+  }
+  // Drawing in background
+  if (page_.draw != page_.show) return getLastResult();
+  return busSendFixed(mask);
+}
+#endif
+
+
 //------------------------------------------------------------------------------
 // Keypad processing
 //------------------------------------------------------------------------------
+#if GBJ_TM1638_KEYPAD
 void gbj_tm1638::registerHandler(gbj_tm1638_handler handler)
 {
   keyProcesing_ = handler;
 }
 
 
-void gbj_tm1638::run()
+#if GBJ_TM1638_DISPATCHERS
+// Registration for all keys replaces all recent ones
+void gbj_tm1638::registerHandler(gbj_tm1638_dispatcher handler, void* context)
+{
+  dispatch_.count = 0;
+  if (handler == NULL) return;
+  dispatch_.entries[0].key = 0;
+  dispatch_.entries[0].action = 0;
+  dispatch_.entries[0].handler = handler;
+  dispatch_.entries[0].context = context;
+  dispatch_.count = 1;
+}
+
+
+// The NULL handler is kept only for masking the registration for all keys
+void gbj_tm1638::registerHandler(uint8_t key, uint8_t action, gbj_tm1638_dispatcher handler, void* context)
+{
+  if (key >= GBJ_TM1638_KEYS_PRESENT || action < KEY_CLICK || action > KEY_HOLD_DOUBLE) return;
+  uint8_t entry = dispatchFind(key, action);
+  if (handler == NULL && dispatchFind(0, 0) == dispatch_.count)
+  {
+    if (entry < dispatch_.count) dispatch_.entries[entry] = dispatch_.entries[--dispatch_.count];
+    return;
+  }
+  if (entry == dispatch_.count)
+  {
+    if (dispatch_.count >= GBJ_TM1638_DISPATCHERS) return;
+    dispatch_.count++;
+  }
+  dispatch_.entries[entry].key = key;
+  dispatch_.entries[entry].action = action;
+  dispatch_.entries[entry].handler = handler;
+  dispatch_.entries[entry].context = context;
+}
+#endif
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+void gbj_tm1638::registerAnimation(gbj_tm1638_animation animation, uint16_t period)
+{
+  animation_.handler = animation;
+  animation_.period = period;
+  animation_.timestamp = millis();
+}
+#endif
+
+
+void gbj_tm1638::run(uint16_t budget)
 {
-  if (status_.keys == 0) return; // No key processing when no key is enabled
+#if GBJ_TM1638_SCHEDULER
+  run_.budget = budget;
+  run_.start = micros();
+  run_.busy = false;
+#else
+  (void) budget;
+#endif
   uint32_t tsNow = millis();
-  if (tsNow - status_.scanTimestamp >= TIMING_SCAN)
+  (void) tsNow; // Without timed features
+#if GBJ_TM1638_KEYPAD
+  // Keypad scanning, no key processing when no key is enabled, slow in idle suspend
+#if GBJ_TM1638_IDLE
+  uint16_t scanPeriod = idle_.active ? idle_.scan : (uint16_t) TIMING_SCAN;
+#else
+  uint16_t scanPeriod = TIMING_SCAN;
+#endif
+  if (status_.keys > 0 && tsNow - status_.scanTimestamp >= scanPeriod && runFits(scan_.cost))
   {
     status_.scanTimestamp = tsNow;
+    uint32_t tsStart = runStart();
     processKeypad();
+    runTask(scan_.cost, tsStart);
+#if GBJ_TM1638_IDLE
+    if (scan_.keys) idleWake(); // Key press is an activity
+#endif
+  }
+#endif
+#if GBJ_TM1638_IDLE
+  // Idle suspend after inactivity period
+  if (idle_.timeout && !idle_.active && tsNow - idle_.timestamp >= idle_.timeout * 1000UL) idleSuspend();
+#endif
+  // Display refresh
+#if GBJ_TM1638_SCHEDULER
+#if GBJ_TM1638_CONCURRENT
+  if (share_.active && !frame_.active) shareTake();
+#endif
+  // The very first frame is not delayed by the period
+  if (!idleActive() && frame_.pending && !frame_.active && (!frame_.started || tsNow - frame_.timestamp >= frame_.period))
+  {
+    frame_.pending = false;
+    frame_.active = frame_.started = true;
+    frame_.addr = 0;
+    frame_.timestamp = tsNow;
+  }
+  runDisplay();
+#else
+#if GBJ_TM1638_CONCURRENT
+  if (share_.active) shareTake();
+#endif
+  if (!idleActive() && frame_.pending) displayNow();
+#endif
+#if GBJ_TM1638_REFRESH
+  // Rolling refresh not competing with transmission of screen buffer
+  if (!idleActive() && refresh_.window && !isDisplayPending() && tsNow - refresh_.timestamp >= refreshPeriod() && runFits(refresh_.cost))
+  {
+    refresh_.timestamp = tsNow;
+    uint32_t tsStart = runStart();
+    runRefresh();
+    runTask(refresh_.cost, tsStart);
+  }
+#endif
+#if GBJ_TM1638_ANIMATION
+  // Blinking
+  if (!idleActive() && blink_.active && tsNow - blink_.timestamp >= blink_.period && runFits(blink_.cost))
+  {
+    blink_.timestamp = tsNow;
+    uint32_t tsStart = runStart();
+    runBlink();
+    runTask(blink_.cost, tsStart);
+  }
+  // Fading
+  if (!idleActive() && fade_.active && tsNow - fade_.timestamp >= TIMING_FADE && runFits(fade_.cost))
+  {
+    fade_.timestamp = tsNow;
+    uint32_t tsStart = runStart();
+    runFade();
+    runTask(fade_.cost, tsStart);
+  }
+  // Animation
+  if (!idleActive() && animation_.handler && tsNow - animation_.timestamp >= animation_.period && runFits(animation_.cost))
+  {
+    animation_.timestamp = tsNow;
+    uint32_t tsStart = runStart();
+    animation_.handler();
+    runTask(animation_.cost, tsStart);
+  }
+#endif
+#if GBJ_TM1638_SCHEDULER
+  // Budget evaluation
+  uint32_t elapsed = micros() - run_.start;
+  if (run_.budget > 0 && elapsed > run_.budget)
+  {
+    if (run_.overruns < 0xFFFF) run_.overruns++;
+    run_.overrunMax = max(run_.overrunMax, (uint16_t) min(elapsed - run_.budget, (uint32_t) 0xFFFF));
+  }
+#endif
+}
+
+
+#if GBJ_TM1638_KEYPAD && GBJ_TM1638_LATENCY_BINS
+void gbj_tm1638::resetKeyLatency()
+{
+  memset(latency_, 0, sizeof(latency_));
+}
+#endif
+
+
+#if GBJ_TM1638_CONCURRENT
+void gbj_tm1638::shareBegin()
+{
+  memcpy(share_.snapshot, page_.frame, BYTES_ADDR);
+  page_.show = getPages() + 1;
+  page_.frame = share_.snapshot;
+  share_.taken = __atomic_load_n(&share_.seq, __ATOMIC_ACQUIRE);
+  share_.active = true;
+}
+
+
+// Writer of sequence lock
+void gbj_tm1638::publish()
+{
+  uint32_t seq = __atomic_load_n(&share_.seq, __ATOMIC_RELAXED);
+  __atomic_store_n(&share_.seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  for (uint8_t addr = 0; addr < BYTES_ADDR; addr++)
+  {
+    __atomic_store_n(&share_.frame[addr], print_.buffer[addr], __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&share_.seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+
+#if defined(ESP32)
+uint8_t gbj_tm1638::taskBegin(uint16_t period, uint16_t budget, uint8_t priority, int core)
+{
+  share_.period = max(period, (uint16_t) 1);
+  share_.budget = budget;
+  if (xTaskCreatePinnedToCore(taskRun, "gbj_tm1638", 4096, this, priority, NULL, core) != pdPASS)
+  {
+    return setLastResult(ERROR_TASK);
   }
+  return getLastResult();
 }
 
+
+void gbj_tm1638::taskRun(void* instance)
+{
+  gbj_tm1638* module = static_cast<gbj_tm1638*>(instance);
+  TickType_t tsWake = xTaskGetTickCount();
+  for (;;)
+  {
+    module->run(module->share_.budget);
+    vTaskDelayUntil(&tsWake, max(pdMS_TO_TICKS(module->share_.period), (TickType_t) 1));
+  }
+}
+#endif
+#endif
+
+
+#if GBJ_TM1638_MIRROR
+// Span of changed addresses includes single unchanged ones
+size_t gbj_tm1638::mirrorExport(Print &out)
+{
+  if (mirror_.dirty == 0) return 0;
+  size_t bytes = 0;
+  uint8_t addr = 0;
+  while (addr < BYTES_ADDR)
+  {
+    if (!(mirror_.dirty & (1 << addr)))
+    {
+      addr++;
+      continue;
+    }
+    uint8_t span = 1;
+    for (uint8_t next = addr + 1; next < BYTES_ADDR; next++)
+    {
+      if (mirror_.dirty & (1 << next)) span = next - addr + 1;
+      else if (next - addr - span >= 1) break;
+    }
+    bytes += out.write((uint8_t) (addr << 4 | (span - 1)));
+    for (uint8_t i = 0; i < span; i++) bytes += out.write(screenByte(addr + i));
+    addr += span;
+  }
+  bytes += out.write((uint8_t) 0xFF); // End of update
+  mirror_.dirty = 0;
+  return bytes;
+}
+#endif
+
+
+#if GBJ_TM1638_TRACE
+void gbj_tm1638::traceDump(Print &out)
+{
+  uint8_t index = (trace_.head + GBJ_TM1638_TRACE - trace_.count) % GBJ_TM1638_TRACE;
+  while (trace_.count)
+  {
+    out.print("T ");
+    out.print(trace_.entries[index].timestamp);
+    out.print(" ");
+    out.print(trace_.entries[index].duration);
+    out.print(" ");
+    if (trace_.entries[index].command < 0x10) out.print("0");
+    out.print(trace_.entries[index].command, HEX);
+    for (uint8_t i = 0; i < trace_.entries[index].bytes; i++)
+    {
+      out.print(trace_.entries[index].payload[i] < 0x10 ? " 0" : " ");
+      out.print(trace_.entries[index].payload[i], HEX);
+    }
+    out.println();
+    index = (index + 1) % GBJ_TM1638_TRACE;
+    trace_.count--;
+  }
+  traceClear();
+}
+#endif
+
 //------------------------------------------------------------------------------
 // Setters
 //------------------------------------------------------------------------------
 uint8_t gbj_tm1638::setContrast(uint8_t contrast)
 {
   status_.contrast = contrast & getContrastMax();
+#if GBJ_TM1638_IDLE
+  if (idle_.active)
+  {
+    idle_.control = CMD_DISP_INIT | CMD_DISP_ON | status_.contrast; // Displayed at waking
+    return getLastResult();
+  }
+#endif
   return busSend(CMD_DISP_INIT | CMD_DISP_ON | status_.contrast);
 }
 
 
+#if GBJ_TM1638_BUS_TIMING
+void gbj_tm1638::setBusTiming(uint8_t profile)
+{
+  bus_.profile = min(profile, (uint8_t) BUS_CABLE);
+  bus_.clkHigh = pgm_read_byte(&busTimingTable[bus_.profile][0]);
+  bus_.clkLow = pgm_read_byte(&busTimingTable[bus_.profile][1]);
+  bus_.strobe = pgm_read_byte(&busTimingTable[bus_.profile][2]);
+}
+#endif
+
+
+#if GBJ_TM1638_REFRESH
+void gbj_tm1638::setRefresh(uint16_t window)
+{
+  refresh_.window = window;
+  refresh_.addr = 0;
+  refresh_.timestamp = millis();
+}
+#endif
+
+
+#if GBJ_TM1638_IDLE
+void gbj_tm1638::setIdle(uint16_t timeout, uint16_t scan)
+{
+  idle_.timeout = timeout;
+  idle_.scan = scan;
+  idle_.timestamp = millis();
+  if (timeout == 0) idleWake();
+}
+#endif
+
+
+#if GBJ_TM1638_PRINT
 void gbj_tm1638::setFont(const uint8_t* fontTable, uint8_t fontTableSize)
 {
   font_.table = fontTable;
   font_.glyphs = fontTableSize / FONT_WIDTH;
 }
+#endif
+
+
+#if GBJ_TM1638_KEYPAD
+// Recent echo is removed
+uint8_t gbj_tm1638::setKeyEcho(uint8_t mode)
+{
+  uint16_t mask = echo_.mask;
+  echo_.mode = min(mode, (uint8_t) ECHO_RADIX);
+  echo_.mask = 0;
+  echo_.keys = 0;
+  return busSendFixed(anodeMask(mask));
+}
+#endif
+
+
+//------------------------------------------------------------------------------
+// Getters
+//------------------------------------------------------------------------------
+#if GBJ_TM1638_KEYPAD && GBJ_TM1638_LATENCY_BINS
+uint16_t gbj_tm1638::getKeyLatency(uint8_t action, uint8_t bin)
+{
+  if (action < KEY_CLICK || action > KEY_HOLD_DOUBLE || bin >= getKeyLatencyBins()) return 0;
+  return latency_[action - 1][bin];
+}
+#endif
 
 
 //------------------------------------------------------------------------------
 // Private methods
 //------------------------------------------------------------------------------
-// Wait for delay period expiry
-void gbj_tm1638::waitPulseClk()
+#if GBJ_TM1638_SCHEDULER
+bool gbj_tm1638::runFits(uint16_t cost)
+{
+  if (run_.budget == 0) return true;
+  if (!run_.busy && cost >= run_.budget) return true; // Sole task in a run
+  return micros() - run_.start + cost <= run_.budget;
+}
+
+
+void gbj_tm1638::runTask(uint16_t &cost, uint32_t tsStart)
+{
+  cost = min(micros() - tsStart, (uint32_t) 0xFFFF);
+  run_.busy = true;
+}
+
+
+void gbj_tm1638::runDisplay()
+{
+#if GBJ_TM1638_ANODE
+  if (frame_.active && status_.anode) anodeUpdate(false);
+#endif
+  while (frame_.active)
+  {
+    // Skip not changed addresses
+    while (frame_.addr < frameBytes() && !isDirty(frame_.addr)) frame_.addr++;
+    if (frame_.addr >= frameBytes())
+    {
+      frame_.active = false;
+      if (frame_.sent < 0xFFFFFFFF) frame_.sent++;
+      return;
+    }
+    // Changed addresses including short gaps cheaper than a new transmission
+    uint8_t bytes = 1;
+    for (uint8_t addr = frame_.addr + 1; addr < frameBytes(); addr++)
+    {
+      if (isDirty(addr)) bytes = addr - frame_.addr + 1;
+      else if (addr - frame_.addr - bytes >= 2) break;
+    }
+    // Bytes fitting the rest of time budget including commands, unknown cost
+    // of a byte is calibrated by sending a sole byte
+    if (run_.budget > 0 && frame_.cost == 0)
+    {
+      bytes = 1;
+    }
+    else if (run_.budget > 0)
+    {
+      uint32_t elapsed = micros() - run_.start;
+      uint16_t fits = elapsed < run_.budget ? (run_.budget - elapsed) / frame_.cost : 0;
+      fits = fits > 2 ? fits - 2 : 0;
+      if (fits == 0 && run_.busy) return;
+      bytes = constrain(fits, 1, bytes);
+    }
+    uint32_t tsStart = micros();
+    if (busSendFrame(frame_.addr, bytes)) return;
+    runTask(frame_.cost, tsStart);
+    frame_.cost = max(frame_.cost / (bytes + 2), 1);
+    frame_.addr += bytes;
+  }
+}
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+uint8_t gbj_tm1638::runBlink()
+{
+  blink_.off = !blink_.off;
+  // Entire display by display control
+  if (blink_.mask == addrMask()) return blink_.off ? displayOff() : displayOn();
+  // Blinking items by fixed addressing
+  return busSendFixed(anodeMask(blink_.mask));
+}
+#endif
+
+
+#if GBJ_TM1638_IDLE
+// Unfinished transmission is replaced by entire one at waking
+uint8_t gbj_tm1638::idleSuspend()
+{
+#if GBJ_TM1638_ANIMATION
+  fade_.active = false;
+#endif
+#if GBJ_TM1638_SCHEDULER
+  frame_.active = false;
+#endif
+  idle_.control = status_.control ? status_.control : CMD_DISP_INIT | CMD_DISP_ON | status_.contrast;
+  displayOff();
+  idle_.active = true;
+  return getLastResult();
+}
+#endif
+
+
+#if GBJ_TM1638_REFRESH
+/*
+  Reassert display control after all addresses. Only transmitted content is
+  resent, so that changed addresses waiting for display are skipped. Every
+  segment row of common anode depends on all grids, so that rows are skipped
+  at any changed grid.
+*/
+uint8_t gbj_tm1638::runRefresh()
+{
+  if (refresh_.addr >= frameBytes())
+  {
+    refresh_.addr = 0;
+    if (status_.control) return busSend(status_.control);
+  }
+  uint16_t mask = 0;
+  for (uint8_t i = 0; i < BYTES_REFRESH && refresh_.addr < frameBytes(); i++)
+  {
+    mask |= 1 << frameAddr(refresh_.addr++);
+  }
+  mask &= ~print_.dirty;
+#if GBJ_TM1638_ANODE
+  const uint16_t grids = 0x5555;
+  if (status_.anode && (!anode_.valid || (print_.dirty & grids))) mask &= ~grids;
+#endif
+  return busSendFixed(mask);
+}
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+void gbj_tm1638::fadeStart(uint8_t from, uint8_t to, uint16_t duration, uint8_t easing, bool pulse)
+{
+  fade_.from = from;
+  fade_.to = to;
+  fade_.duration = duration;
+  fade_.easing = easing;
+  fade_.pulse = pulse && duration > 0;
+  fade_.sent = 0xFF; // Force sending the starting level
+  fade_.error = 0;
+  fade_.start = fade_.timestamp = millis();
+  fade_.active = true;
+}
+
+
+// Output level in fixed point 8.8 format interpolated by easing
+uint8_t gbj_tm1638::runFade()
+{
+  uint32_t elapsed = millis() - fade_.start;
+  if (elapsed >= fade_.duration)
+  {
+    if (!fade_.pulse)
+    {
+      fade_.active = false;
+      return fadeSend(fade_.to);
+    }
+    uint8_t level = fade_.from;
+    fade_.from = fade_.to;
+    fade_.to = level;
+    fade_.start += fade_.duration;
+    elapsed -= fade_.duration;
+    // Restart after a long pause of runs
+    if (elapsed >= fade_.duration)
+    {
+      fade_.start = millis();
+      elapsed = 0;
+    }
+  }
+  uint16_t progress = elapsed * 256 / fade_.duration;
+  if (fade_.easing == EASE_QUAD)
+  {
+    progress = progress < 128 ? progress * progress / 128 : 256 - (256 - progress) * (256 - progress) / 128;
+  }
+  int16_t level = (fade_.from << 8) + ((int16_t) fade_.to - fade_.from) * (int16_t) progress;
+  uint8_t fraction = level & 0xFF;
+  level >>= 8;
+  if (fade_.dither)
+  {
+    // Upper level in the ratio of the fraction
+    uint16_t error = fade_.error + fraction;
+    fade_.error = error & 0xFF;
+    if (error > 0xFF) level++;
+  }
+  else if (fraction >= 0x80)
+  {
+    level++;
+  }
+  return fadeSend(level);
+}
+
+
+uint8_t gbj_tm1638::fadeSend(uint8_t level)
+{
+  if (level == fade_.sent) return getLastResult();
+  fade_.sent = level;
+  if (level == 0) return displayOff();
+  return busSend(CMD_DISP_INIT | CMD_DISP_ON | (level - 1));
+}
+#endif
+
+
+// Mapping between controller's and screen buffer's addresses is symmetric
+uint8_t gbj_tm1638::frameAddr(uint8_t addr)
+{
+  if (status_.orientation == ORIENT_NORMAL) return addr;
+  if (addr % 2)
+  {
+    uint8_t led = addr / 2;
+    return led < status_.leds ? addrLed(status_.leds - 1 - led) : addr;
+  }
+  else
+  {
+    uint8_t digit = addr / 2;
+    return digit < status_.digits ? addrGrid(status_.digits - 1 - digit) : addr;
+  }
+}
+
+
+uint8_t gbj_tm1638::frameByte(uint8_t addr)
 {
-  delayMicroseconds(TIMING_RELAX);
+#if GBJ_TM1638_ANODE
+  if (status_.anode && addr % 2 == 0) return anode_.rows[addr / 2];
+#endif
+  return frameSource(addr);
 }
 
 
+// Transmitted byte at controller's address differs from screen buffer
+// at blinking items in off phase, at echoed keys, and at other than normal
+// orientation
+uint8_t gbj_tm1638::frameSource(uint8_t addr)
+{
+  bool grid = addr % 2 == 0;
+  addr = frameAddr(addr);
+  uint8_t data = screenByte(addr);
+#if GBJ_TM1638_ANIMATION
+  if (blink_.off && (blink_.mask & (1 << addr)) && blink_.mask != addrMask()) data = 0x00;
+#endif
+#if GBJ_TM1638_KEYPAD
+  if (echo_.mask & (1 << addr))
+  {
+    if (grid) data ^= 0x80;
+    else data = echo_.mode == ECHO_GREEN ? LED_GREEN : LED_RED;
+  }
+#endif
+  if (grid && status_.orientation != ORIENT_NORMAL)
+  {
+    data = (data & 0x80) | pgm_read_byte(&orientationTable[status_.orientation - 1][data & 0x7F]);
+  }
+  return data;
+}
+
+
+#if GBJ_TM1638_ANODE
+// Rows already marked and not transmitted yet stay marked
+uint16_t gbj_tm1638::anodeUpdate(bool force)
+{
+  const uint16_t grids = 0x5555;
+  if (!force && anode_.valid && !(print_.dirty & grids)) return 0;
+  uint8_t digits[DIGITS];
+  uint8_t rows[DIGITS];
+  for (uint8_t digit = 0; digit < DIGITS; digit++)
+  {
+    digits[digit] = digit < status_.digits ? frameSource(addrGrid(digit)) : 0x00;
+  }
+  bitTranspose(digits, rows);
+  uint16_t changed = 0;
+  for (uint8_t row = 0; row < DIGITS; row++)
+  {
+    if (!anode_.valid || rows[row] != anode_.rows[row]) changed |= 1 << frameAddr(addrGrid(row));
+    anode_.rows[row] = rows[row];
+  }
+  anode_.valid = true;
+  uint16_t pending = print_.dirty & anode_.marked;
+  print_.dirty = (print_.dirty & ~grids) | pending | changed;
+  anode_.marked = pending | changed;
+  return changed;
+}
+
+
+// Digital tubes in the mask are replaced with changed segment rows
+uint16_t gbj_tm1638::anodeMask(uint16_t mask)
+{
+  const uint16_t grids = 0x5555;
+  if (!status_.anode || !(mask & grids)) return mask;
+  return (mask & ~grids) | anodeUpdate(true);
+}
+
+
+/*
+  SWAR transposition in two 32-bit halves by Hacker's Delight, which maps
+  bit 7 - j of byte i to bit 7 - i of byte j. Reversed order of input and
+  output bytes turns it to mapping of bit j of byte i to bit i of byte j.
+*/
+void gbj_tm1638::bitTranspose(const uint8_t* in, uint8_t* out)
+{
+  uint32_t x = ((uint32_t) in[7] << 24) | ((uint32_t) in[6] << 16) | ((uint32_t) in[5] << 8) | in[4];
+  uint32_t y = ((uint32_t) in[3] << 24) | ((uint32_t) in[2] << 16) | ((uint32_t) in[1] << 8) | in[0];
+  uint32_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+  out[7] = x >> 24;
+  out[6] = x >> 16;
+  out[5] = x >> 8;
+  out[4] = x;
+  out[3] = y >> 24;
+  out[2] = y >> 16;
+  out[1] = y >> 8;
+  out[0] = y;
+}
+#endif
+
+
 // Start condition - pull down STB from HIGH to LOW
 void gbj_tm1638::beginTransmission()
 {
   digitalWrite(status_.pinStb, HIGH); // Finish previous communication for sure
   digitalWrite(status_.pinClk, HIGH);
+  waitStrobe();
   digitalWrite(status_.pinStb, LOW); // Start communication
+  waitStrobe();
 }
 
 
@@ -169,42 +999,77 @@ void gbj_tm1638::endTransmission()
 }
 
 
+// Bits are sampled by the controller at rising edge of clock pulse
 void gbj_tm1638::busWrite(uint8_t data)
 {
-  digitalWrite(status_.pinClk, LOW); // For active rising edge of clock pulse
-  shiftOut(status_.pinDio, status_.pinClk, LSBFIRST, data);
+  for (uint8_t bit = 0; bit < 8; bit++)
+  {
+    digitalWrite(status_.pinClk, LOW);
+    digitalWrite(status_.pinDio, data & 0x01);
+    waitClkLow();
+    digitalWrite(status_.pinClk, HIGH);
+    waitClkHigh();
+    data >>= 1;
+  }
 }
 
 
+#if GBJ_TM1638_KEYPAD
+// Bits are output by the controller at falling edge of clock pulse
 uint8_t gbj_tm1638::busRead()
 {
-  digitalWrite(status_.pinClk, LOW); // For active rising edge of clock pulse
-  uint8_t data = shiftIn(status_.pinDio, status_.pinClk, LSBFIRST);
+  uint8_t data = 0;
+  for (uint8_t bit = 0; bit < 8; bit++)
+  {
+    digitalWrite(status_.pinClk, LOW);
+    waitClkLow();
+    digitalWrite(status_.pinClk, HIGH);
+    if (digitalRead(status_.pinDio)) data |= 1 << bit;
+    waitClkHigh();
+  }
   return data;
 }
+#endif
 
 
 uint8_t gbj_tm1638::busSend(uint8_t command)
 {
+#if GBJ_TM1638_TRACE
+  uint32_t tsStart = micros();
+#endif
+  if ((command & 0xC0) == CMD_DISP_INIT) status_.control = command; // For rolling refresh
   beginTransmission();
   busWrite(setLastCommand(command));
   endTransmission();
+#if GBJ_TM1638_TRACE
+  traceRecord(tsStart, command, NULL, 0);
+#endif
   return getLastResult();
 }
 
 
 uint8_t gbj_tm1638::busSend(uint8_t command, uint8_t data)
 {
+#if GBJ_TM1638_TRACE
+  uint32_t tsStart = micros();
+#endif
   beginTransmission();
   busWrite(setLastCommand(command));
   busWrite(data);
   endTransmission();
+#if GBJ_TM1638_TRACE
+  traceRecord(tsStart, command, &data, 1);
+#endif
   return getLastResult();
 }
 
 
 uint8_t gbj_tm1638::busSend(uint8_t command, uint8_t* buffer, uint8_t bufferItems)
 {
+#if GBJ_TM1638_TRACE
+  uint32_t tsStart = micros();
+  const uint8_t* payload = buffer;
+#endif
   beginTransmission();
   busWrite(setLastCommand(command));
   for (uint8_t bufferIndex = 0; bufferIndex < bufferItems; bufferIndex++)
@@ -212,40 +1077,131 @@ uint8_t gbj_tm1638::busSend(uint8_t command, uint8_t* buffer, uint8_t bufferItem
     busWrite(*buffer++);
   }
   endTransmission();
+#if GBJ_TM1638_TRACE
+  traceRecord(tsStart, command, payload, bufferItems);
+#endif
+  return getLastResult();
+}
+
+
+uint8_t gbj_tm1638::busSendFrame(uint8_t addr, uint8_t bytes)
+{
+  // Automatic addressing
+  uint8_t buffer[BYTES_ADDR];
+  for (uint8_t i = 0; i < bytes; i++)
+  {
+    buffer[i] = frameByte(addr + i);
+    print_.dirty &= ~(1 << frameAddr(addr + i));
+  }
+  if (busSend(CMD_DATA_INIT | CMD_DATA_NORMAL | CMD_DATA_WRITE | CMD_DATA_AUTO)) return getLastResult();
+  return busSend(CMD_ADDR_INIT | addr, buffer, bytes);
+}
+
+
+uint8_t gbj_tm1638::busSendFixed(uint16_t mask)
+{
+  if (mask == 0 || idleActive()) return getLastResult();
+  // Fixed addressing
+  if (busSend(CMD_DATA_INIT | CMD_DATA_NORMAL | CMD_DATA_WRITE | CMD_DATA_FIXED)) return getLastResult();
+  for (uint8_t addr = 0; addr < BYTES_ADDR; addr++)
+  {
+    if (!(mask & (1 << addr))) continue;
+    print_.dirty &= ~(1 << addr);
+    uint8_t addrFrame = frameAddr(addr);
+    if (busSend(CMD_ADDR_INIT | addrFrame, frameByte(addrFrame))) return getLastResult();
+  }
   return getLastResult();
 }
 
 
+#if GBJ_TM1638_KEYPAD
 uint8_t gbj_tm1638::busReceive(uint8_t command, uint8_t* buffer)
 {
+#if GBJ_TM1638_TRACE
+  uint32_t tsStart = micros();
+#endif
   beginTransmission();
   busWrite(setLastCommand(command));
   // Read bytes
   pinMode(status_.pinDio, INPUT);
+  waitStrobe(); // Waiting time before reading
   for (uint8_t bufferIndex = 0; bufferIndex < BYTES_SCAN; bufferIndex++)
   {
     buffer[bufferIndex] = busRead();
   }
   pinMode(status_.pinDio, OUTPUT);
   endTransmission();
+#if GBJ_TM1638_TRACE
+  traceRecord(tsStart, command, buffer, BYTES_SCAN);
+#endif
   return getLastResult();
 }
+#endif
 
 
 // The method leaves digit cursor after last print digit
 void gbj_tm1638::gridWrite(uint8_t segmentMask, uint8_t gridStart, uint8_t gridStop)
 {
   swapByte(gridStart, gridStop);
-  gridStop = min(gridStop, status_.digits - 1);
+  gridStop = min(gridStop, (uint8_t) (status_.digits - 1));
   for (print_.digit = gridStart; print_.digit <= gridStop; print_.digit++)
   {
     segmentMask &= 0x7F; // Clear radix bit in segment mask
-    print_.buffer[addrGrid(print_.digit)] &= 0x80;  // Clear digit bits in screen buffer
-    print_.buffer[addrGrid(print_.digit)] |= segmentMask;  // Set digit bits but leave radix bit intact
+    // Set digit bits but leave radix bit intact
+    bufferSet(addrGrid(print_.digit), (print_.buffer[addrGrid(print_.digit)] & 0x80) | segmentMask);
+  }
+}
+
+
+#if GBJ_TM1638_CONCURRENT
+// Reader of sequence lock postpones taking at publishing in progress
+void gbj_tm1638::shareTake()
+{
+  uint32_t seq = __atomic_load_n(&share_.seq, __ATOMIC_ACQUIRE);
+  if (seq == share_.taken) return;
+  uint8_t frame[BYTES_ADDR];
+  if (!(seq & 1))
+  {
+    for (uint8_t addr = 0; addr < BYTES_ADDR; addr++)
+    {
+      frame[addr] = __atomic_load_n(&share_.frame[addr], __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  }
+  if ((seq & 1) || seq != __atomic_load_n(&share_.seq, __ATOMIC_RELAXED))
+  {
+    share_.retries++;
+    return;
   }
+  share_.taken = seq;
+  for (uint8_t addr = 0; addr < BYTES_ADDR; addr++)
+  {
+    if (share_.snapshot[addr] == frame[addr]) continue;
+    share_.snapshot[addr] = frame[addr];
+    print_.dirty |= 1 << addr;
+    mirrorMark(1 << addr);
+  }
+  displayDefer();
 }
+#endif
 
 
+#if GBJ_TM1638_TRACE
+void gbj_tm1638::traceRecord(uint32_t tsStart, uint8_t command, const uint8_t* payload, uint8_t bytes)
+{
+  uint32_t duration = micros() - tsStart;
+  trace_.entries[trace_.head].timestamp = tsStart;
+  trace_.entries[trace_.head].duration = min(duration, (uint32_t) 0xFFFF);
+  trace_.entries[trace_.head].command = command;
+  trace_.entries[trace_.head].bytes = min(bytes, (uint8_t) BYTES_ADDR);
+  if (payload) memcpy(trace_.entries[trace_.head].payload, payload, trace_.entries[trace_.head].bytes);
+  trace_.head = (trace_.head + 1) % GBJ_TM1638_TRACE;
+  if (trace_.count < GBJ_TM1638_TRACE) trace_.count++;
+}
+#endif
+
+
+#if GBJ_TM1638_PRINT
 uint8_t gbj_tm1638::getFontMask(uint8_t ascii)
 {
   uint8_t mask = FONT_MASK_WRONG;
@@ -261,6 +1217,187 @@ uint8_t gbj_tm1638::getFontMask(uint8_t ascii)
   return mask;
 }
 
+// The method leaves digit cursor after last printed digit like the write()
+uint8_t gbj_tm1638::textMasks(const uint8_t* text, size_t size, uint8_t* masks, uint8_t &digit, uint8_t digits)
+{
+  uint8_t printed = 0;
+  for (size_t i = 0; i < size && digit < digits; i++)
+  {
+    uint8_t mask = getFontMask(text[i]);
+    if (mask == FONT_MASK_WRONG)
+    {
+      // Set radix to the previous digit
+      if ((text[i] == '.' || text[i] == ',' || text[i] == ':') && digit > 0)
+      {
+        masks[digit - 1] |= 0x80;
+      }
+    }
+    else
+    {
+      masks[digit] = (masks[digit] & 0x80) | mask;
+      digit++;
+      printed++;
+    }
+  }
+  return printed;
+}
+
+
+void gbj_tm1638::renderText(const uint8_t* text, size_t size, uint8_t digit, bool keepRadix)
+{
+  uint8_t masks[DIGITS];
+  for (uint8_t i = 0; i < status_.digits; i++)
+  {
+    masks[i] = keepRadix ? print_.buffer[addrGrid(i)] & 0x80 : 0x00;
+  }
+  print_.digit = status_.digits;
+  placePrint(digit);
+  textMasks(text, size, masks, print_.digit, status_.digits);
+  for (uint8_t i = 0; i < status_.digits; i++) bufferSet(addrGrid(i), masks[i]);
+}
+
+
+#if GBJ_TM1638_FIELDS
+void gbj_tm1638::fieldBegin(uint8_t field, uint8_t digit, uint8_t width, uint8_t align, char padding)
+{
+  if (field >= GBJ_TM1638_FIELDS || digit >= status_.digits || width == 0) return;
+  fields_[field].digit = digit;
+  fields_[field].width = min(width, (uint8_t) (status_.digits - digit));
+  fields_[field].align = align;
+  fields_[field].padding = padding;
+  fields_[field].printed = false;
+  fields_[field].hysteresis = 0;
+  fields_[field].period = 0;
+}
+
+
+void gbj_tm1638::fieldLimit(uint8_t field, float hysteresis, uint16_t period)
+{
+  if (field >= GBJ_TM1638_FIELDS) return;
+  fields_[field].hysteresis = hysteresis;
+  fields_[field].period = period;
+}
+
+
+// Digits of text are counted at first for right alignment
+void gbj_tm1638::fieldPrint(uint8_t field, const char* text)
+{
+  if (field >= GBJ_TM1638_FIELDS || fields_[field].width == 0) return;
+  uint8_t width = fields_[field].width;
+  uint8_t masks[DIGITS];
+  uint8_t padding = getFontMask(fields_[field].padding);
+  if (padding == FONT_MASK_WRONG) padding = 0x00;
+  for (uint8_t i = 0; i < width; i++) masks[i] = padding;
+  uint8_t digit = 0;
+  if (fields_[field].align == ALIGN_RIGHT)
+  {
+    uint8_t glyphs = 0;
+    for (uint8_t i = 0; text[i] != '\0' && glyphs < width; i++)
+    {
+      if (getFontMask(text[i]) != FONT_MASK_WRONG) glyphs++;
+    }
+    digit = width - glyphs;
+  }
+  textMasks((const uint8_t*) text, strlen(text), masks, digit, width);
+  for (uint8_t i = 0; i < width; i++) bufferSet(addrGrid(fields_[field].digit + i), masks[i]);
+}
+
+
+void gbj_tm1638::fieldPrint(uint8_t field, long value)
+{
+  if (!fieldChanged(field, value)) return;
+  fieldNumber(field, value < 0 ? -(unsigned long) value : value, value < 0, 0);
+}
+
+
+void gbj_tm1638::fieldPrint(uint8_t field, unsigned long value)
+{
+  if (!fieldChanged(field, value)) return;
+  fieldNumber(field, value, false, 0);
+}
+
+
+// Numbers beyond the range of the fixed point magnitude overflow
+void gbj_tm1638::fieldPrint(uint8_t field, float value, uint8_t decimals)
+{
+  if (!fieldChanged(field, value)) return;
+  decimals = min(decimals, (uint8_t) (DIGITS - 1));
+  float scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+  float scaled = (value < 0 ? -value : value) * scale + 0.5;
+  if (!(scaled < 4.0e9)) scaled = 4.0e9; // Wider than any field
+  unsigned long magnitude = scaled;
+  fieldNumber(field, magnitude, value < 0 && magnitude > 0, decimals);
+}
+
+
+/*
+  Number is formatted as fixed point with decimals. Decimals not fitting
+  the field are rounded off, and the number not fitting the field even
+  without decimals is displayed as dashes.
+*/
+void gbj_tm1638::fieldNumber(uint8_t field, unsigned long magnitude, bool negative, uint8_t decimals)
+{
+  uint8_t width = fields_[field].width;
+  uint8_t count;
+  for (;;)
+  {
+    count = 1;
+    for (unsigned long rest = magnitude / 10; rest > 0; rest /= 10) count++;
+    count = max(count, (uint8_t) (decimals + 1));
+    if (negative + count <= width || decimals == 0) break;
+    magnitude = magnitude / 10 + (magnitude % 10 >= 5 ? 1 : 0);
+    decimals--;
+    negative = negative && magnitude > 0;
+  }
+  if (negative + count > width)
+  {
+    for (uint8_t i = 0; i < width; i++) bufferSet(addrGrid(fields_[field].digit + i), 0x40);
+    return;
+  }
+  char text[14];
+  uint8_t length = 0;
+  if (negative) text[length++] = '-';
+  // Digits in reverse order including leading zeros of decimals
+  char digits[11];
+  count = 0;
+  do
+  {
+    digits[count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  }
+  while (magnitude > 0 || count <= decimals);
+  while (count > 0)
+  {
+    text[length++] = digits[--count];
+    if (count == decimals && count > 0) text[length++] = '.';
+  }
+  text[length] = '\0';
+  fieldPrint(field, text);
+}
+
+
+bool gbj_tm1638::fieldChanged(uint8_t field, float value)
+{
+  if (field >= GBJ_TM1638_FIELDS) return false;
+  uint32_t tsNow = millis();
+  if (fields_[field].printed)
+  {
+    float change = value - fields_[field].value;
+    if (change < 0) change = -change;
+    if (change < fields_[field].hysteresis) return false;
+    if (tsNow - fields_[field].timestamp < fields_[field].period) return false;
+  }
+  fields_[field].printed = true;
+  fields_[field].value = value;
+  fields_[field].timestamp = tsNow;
+  return true;
+}
+#endif
+#endif
+
+
+#if GBJ_TM1638_KEYPAD
 /*
     Mapping of hardware switches to controller's keys
     S1 - K3/KS1 - BYTE1
@@ -271,95 +1408,201 @@ uint8_t gbj_tm1638::getFontMask(uint8_t ascii)
     S6 - K3/KS4 - BYTE2
     S7 - K3/KS6 - BYTE3
     S8 - K3/KS8 - BYTE4
+
+    Mapping at common anode boards with 16 keys
+    S1, S2 - K1/KS1, K1/KS2 - BYTE1 ... S7, S8 - K1/KS7, K1/KS8 - BYTE4
+    S9, S10 - K2/KS1, K2/KS2 - BYTE1 ... S15, S16 - K2/KS7, K2/KS8 - BYTE4
 */
-uint8_t gbj_tm1638::processKeypad()
+uint32_t gbj_tm1638::readKeys()
 {
   uint8_t buffer[BYTES_SCAN];
   // Read all possible keys including not hardware implemented
-  if (busReceive(CMD_DATA_INIT | CMD_DATA_NORMAL | CMD_DATA_READ, buffer)) return getLastResult();
-  // Scan buses from K3 in descending order according to the datasheet
-  for (uint8_t bus = 0; bus < status_.keys / 8 + 1; bus++)
+  if (busReceive(CMD_DATA_INIT | CMD_DATA_NORMAL | CMD_DATA_READ, buffer)) return scan_.keys;
+  scan_.keys = 0;
+#if GBJ_TM1638_ANODE
+  if (status_.anode)
   {
-    uint8_t keyMask = 0;
-    uint8_t bitMask = 0b10001 << bus; // Scanned keys for a bus
-    for (uint8_t scanByte = 0; scanByte < sizeof(buffer) / sizeof(buffer[0]); scanByte++)
+    // Pairs of keys in scanned bytes on lines K1 and K2 of common anode boards
+    for (uint8_t line = 0; line < 2; line++)
     {
-      keyMask |= ((buffer[scanByte] & bitMask) >> bus) << scanByte; // Shift bus bit to first position
+      for (uint8_t scanByte = 0; scanByte < sizeof(buffer) / sizeof(buffer[0]); scanByte++)
+      {
+        if (buffer[scanByte] & (0b00100 >> line)) scan_.keys |= 1UL << (8 * line + 2 * scanByte);
+        if (buffer[scanByte] & (0b1000000 >> line)) scan_.keys |= 1UL << (8 * line + 2 * scanByte + 1);
+      }
+    }
+  }
+  else
+#endif
+  {
+    // Scan buses from K3 in descending order according to the datasheet
+    for (uint8_t bus = 0; bus < 3; bus++)
+    {
+      for (uint8_t scanByte = 0; scanByte < sizeof(buffer) / sizeof(buffer[0]); scanByte++)
+      {
+        if (buffer[scanByte] & (0b00001 << bus)) scan_.keys |= 1UL << (8 * bus + scanByte);
+        if (buffer[scanByte] & (0b10000 << bus)) scan_.keys |= 1UL << (8 * bus + scanByte + 4);
+      }
+    }
+  }
+  scan_.keys &= status_.keys < 32 ? (1UL << status_.keys) - 1 : 0xFFFFFFFF;
+  return scan_.keys;
+}
+
+
+uint8_t gbj_tm1638::processKeypad()
+{
+  uint32_t keyMask = readKeys();
+  if (isError()) return getLastResult();
+  if (echo_.mode && keyMask != echo_.keys) processEcho(keyMask);
+  if (!scan_.actions) return getLastResult();
+  for (uint8_t key = 0; key < status_.keys; key++)
+  {
+    bool keyPressed = keyMask & (1UL << key);
+    uint8_t keyState;
+    // Determine current key state
+    if (keyPressed)
+    {
+      keys_[key].waitScans = 0;
+      keyState = KEY_PRESS_SHORT;
+      if (keys_[key].pressScans < 255) keys_[key].pressScans++;
+      if (keys_[key].pressScans >= TIMING_SCAN_TRESHOLD_PRESS_LONG) keyState = KEY_PRESS_LONG;
+    }
+    else
+    {
+      keys_[key].pressScans = 0;
+      keyState = KEY_WAIT_SHORT;
+      if (keys_[key].waitScans < 255) keys_[key].waitScans++;
+      if (keys_[key].waitScans >= TIMING_SCAN_TRESHOLD_WAIT) keyState = KEY_WAIT_LONG;
     }
-    // Process keys in a bus
-    for (uint8_t keyBit = 0; keyBit < 8; keyBit++)
+    // Process action if state has changed
+    if (keys_[key].keyState[0] != keyState)
     {
-      uint8_t key = keyBit + (8 * bus);
-      if (key >= status_.keys) break;
-      bool keyPressed = keyMask & (1 << keyBit);
-      uint8_t keyState;
-      // Determine current key state
-      if (keyPressed)
+#if GBJ_TM1638_LATENCY_BINS
+      // Press after long release starts a new action
+      if (keyState == KEY_PRESS_SHORT && keys_[key].keyState[0] == KEY_WAIT_LONG)
+      {
+        keys_[key].pressTimestamp = status_.scanTimestamp;
+      }
+#endif
+      // Historize key states
+      for (uint8_t i = sizeof(keys_[key].keyState) / sizeof(keys_[key].keyState[0]) - 1; i > 0; i--)
+      {
+        keys_[key].keyState[i] = keys_[key].keyState[i - 1];
+      }
+      keys_[key].keyState[0] = keyState;
+      // Determine action type from key state pattern
+      uint8_t keyAction = 0;
+      if (
+         keys_[key].keyState[0] == KEY_WAIT_SHORT
+      && keys_[key].keyState[1] == KEY_PRESS_SHORT
+      && keys_[key].keyState[2] == KEY_WAIT_SHORT
+      && keys_[key].keyState[3] == KEY_PRESS_SHORT
+      && keys_[key].keyState[4] == KEY_WAIT_LONG
+      )
+      {
+        keyAction = KEY_CLICK_DOUBLE;
+      }
+      if (
+         keys_[key].keyState[0] == KEY_WAIT_LONG
+      && keys_[key].keyState[1] == KEY_WAIT_SHORT
+      && keys_[key].keyState[2] == KEY_PRESS_SHORT
+      && keys_[key].keyState[3] == KEY_WAIT_LONG
+      )
       {
-        keys_[key].waitScans = 0;
-        keyState = KEY_PRESS_SHORT;
-        if (keys_[key].pressScans < 255) keys_[key].pressScans++;
-        if (keys_[key].pressScans >= TIMING_SCAN_TRESHOLD_PRESS_LONG) keyState = KEY_PRESS_LONG;
+        keyAction = KEY_CLICK;
       }
-      else
+      if (
+         keys_[key].keyState[0] == KEY_PRESS_LONG
+      && keys_[key].keyState[1] == KEY_PRESS_SHORT
+      && keys_[key].keyState[2] == KEY_WAIT_SHORT
+      && keys_[key].keyState[3] == KEY_PRESS_SHORT
+      && keys_[key].keyState[4] == KEY_WAIT_LONG
+      )
       {
-        keys_[key].pressScans = 0;
-        keyState = KEY_WAIT_SHORT;
-        if (keys_[key].waitScans < 255) keys_[key].waitScans++;
-        if (keys_[key].waitScans >= TIMING_SCAN_TRESHOLD_WAIT) keyState = KEY_WAIT_LONG;
+        keyAction = KEY_HOLD_DOUBLE;
       }
-      // Process action if state has changed
-      if (keys_[key].keyState[0] != keyState)
+      if (
+         keys_[key].keyState[0] == KEY_PRESS_LONG
+      && keys_[key].keyState[1] == KEY_PRESS_SHORT
+      && keys_[key].keyState[2] == KEY_WAIT_LONG
+      )
       {
-        // Historize key states
-        for (uint8_t i = sizeof(keys_[key].keyState) / sizeof(keys_[key].keyState[0]) - 1; i > 0; i--)
-        {
-          keys_[key].keyState[i] = keys_[key].keyState[i - 1];
-        }
-        keys_[key].keyState[0] = keyState;
-        // Determine action type from key state pattern
-        uint8_t keyAction = 0;
-        if (
-           keys_[key].keyState[0] == KEY_WAIT_SHORT
-        && keys_[key].keyState[1] == KEY_PRESS_SHORT
-        && keys_[key].keyState[2] == KEY_WAIT_SHORT
-        && keys_[key].keyState[3] == KEY_PRESS_SHORT
-        && keys_[key].keyState[4] == KEY_WAIT_LONG
-        )
-        {
-          keyAction = KEY_CLICK_DOUBLE;
-        }
-        if (
-           keys_[key].keyState[0] == KEY_WAIT_LONG
-        && keys_[key].keyState[1] == KEY_WAIT_SHORT
-        && keys_[key].keyState[2] == KEY_PRESS_SHORT
-        && keys_[key].keyState[3] == KEY_WAIT_LONG
-        )
-        {
-          keyAction = KEY_CLICK;
-        }
-        if (
-           keys_[key].keyState[0] == KEY_PRESS_LONG
-        && keys_[key].keyState[1] == KEY_PRESS_SHORT
-        && keys_[key].keyState[2] == KEY_WAIT_SHORT
-        && keys_[key].keyState[3] == KEY_PRESS_SHORT
-        && keys_[key].keyState[4] == KEY_WAIT_LONG
-        )
-        {
-          keyAction = KEY_HOLD_DOUBLE;
-        }
-        if (
-           keys_[key].keyState[0] == KEY_PRESS_LONG
-        && keys_[key].keyState[1] == KEY_PRESS_SHORT
-        && keys_[key].keyState[2] == KEY_WAIT_LONG
-        )
-        {
-          keyAction = KEY_HOLD;
-        }
-        // Call key handler with key action
-        if (keyAction && keyProcesing_) keyProcesing_(key, keyAction);
+        keyAction = KEY_HOLD;
+      }
+      // Call key handler with key action
+      if (keyAction)
+      {
+#if GBJ_TM1638_LATENCY_BINS
+        processLatency(key, keyAction);
+#endif
+        processAction(key, keyAction);
       }
     }
   }
   return getLastResult();
 }
+
+
+// Echoed addresses are transmitted at once right after the scan
+uint8_t gbj_tm1638::processEcho(uint32_t keyMask)
+{
+  uint16_t mask = 0;
+  uint32_t changed = keyMask ^ echo_.keys;
+  echo_.keys = keyMask;
+  for (uint8_t key = 0; key < DIGITS; key++)
+  {
+    if (!(changed & (1UL << key))) continue;
+    if (echo_.mode == ECHO_RADIX ? key >= status_.digits : key >= status_.leds) continue;
+    uint8_t addr = echo_.mode == ECHO_RADIX ? addrGrid(key) : addrLed(key);
+    if (keyMask & (1UL << key))
+    {
+      echo_.mask |= 1 << addr;
+    }
+    else
+    {
+      echo_.mask &= ~(1 << addr);
+    }
+    mask |= 1 << addr;
+  }
+  return busSendFixed(anodeMask(mask));
+}
+
+
+// Registration for a key and action precedes the one for all keys
+void gbj_tm1638::processAction(uint8_t key, uint8_t action)
+{
+#if GBJ_TM1638_DISPATCHERS
+  uint8_t entry = dispatchFind(key, action);
+  if (entry == dispatch_.count) entry = dispatchFind(0, 0);
+  if (entry < dispatch_.count && dispatch_.entries[entry].handler)
+  {
+    dispatch_.entries[entry].handler(this, key, action, dispatch_.entries[entry].context);
+    return;
+  }
+#endif
+  if (keyProcesing_) keyProcesing_(key, action);
+}
+
+
+#if GBJ_TM1638_DISPATCHERS
+uint8_t gbj_tm1638::dispatchFind(uint8_t key, uint8_t action)
+{
+  uint8_t entry = 0;
+  while (entry < dispatch_.count \
+  && (dispatch_.entries[entry].key != key || dispatch_.entries[entry].action != action)) entry++;
+  return entry;
+}
+#endif
+
+
+#if GBJ_TM1638_LATENCY_BINS
+void gbj_tm1638::processLatency(uint8_t key, uint8_t action)
+{
+  keys_[key].actionTimestamp = status_.scanTimestamp;
+  uint32_t latency = keys_[key].actionTimestamp - keys_[key].pressTimestamp;
+  uint8_t bin = min(latency / getKeyLatencyWidth(), (uint32_t) getKeyLatencyBins() - 1);
+  if (latency_[action - 1][bin] < 0xFFFF) latency_[action - 1][bin]++;
+}
+#endif
+#endif
@@ -46,9 +46,86 @@
 #endif
 
 // Hardware
+/*
+  Configuration constants change the layout of the class, so that they must be
+  defined in build flags of a project, e.g., -DGBJ_TM1638_PAGES=4, which both
+  a sketch and the separately compiled library see. The method begin() fails
+  with ERROR_CONFIG, if they differ.
+*/
 #ifndef GBJ_TM1638_KEYS_PRESENT
-#define GBJ_TM1638_KEYS_PRESENT     8 // Redefine it in advance in a sketch for your module
+#define GBJ_TM1638_KEYS_PRESENT     8 // Redefine it in build flags for your module
+#endif
+#ifndef GBJ_TM1638_LATENCY_BINS
+#define GBJ_TM1638_LATENCY_BINS     8 // Bins of key action latency histogram, 0 for no histogram
+#endif
+#ifndef GBJ_TM1638_DISPATCHERS
+#define GBJ_TM1638_DISPATCHERS      4 // Registrations of instance aware key handlers, 0 for none
+#endif
+
+// Screen pages
+#ifndef GBJ_TM1638_PAGES
+#define GBJ_TM1638_PAGES            2 // Screen pages in SRAM including the default one, at least 1
+#endif
+
+// Screen fields
+#ifndef GBJ_TM1638_FIELDS
+#define GBJ_TM1638_FIELDS           4 // Declarable fields of digital tubes, 0 for no fields
+#endif
+
+// Concurrency
+#ifndef GBJ_TM1638_CONCURRENT
+  #if defined(ESP32)
+    #define GBJ_TM1638_CONCURRENT     1 // Shared screen for multitasking
+  #else
+    #define GBJ_TM1638_CONCURRENT     0
+  #endif
+#endif
+
+// Features, 0 for excluding from the build
+#ifndef GBJ_TM1638_KEYPAD
+#define GBJ_TM1638_KEYPAD           1 // Keypad scanning and key actions
+#endif
+#ifndef GBJ_TM1638_PRINT
+#define GBJ_TM1638_PRINT            1 // Print class, fonts, text, and fields
+#endif
+#ifndef GBJ_TM1638_LEDS
+#define GBJ_TM1638_LEDS             1 // Module's LEDs and level meter
 #endif
+#ifndef GBJ_TM1638_ANIMATION
+#define GBJ_TM1638_ANIMATION        1 // Animation procedure, blinking, and fading
+#endif
+#ifndef GBJ_TM1638_ANODE
+#define GBJ_TM1638_ANODE            1 // Common anode wiring of digital tubes
+#endif
+#ifndef GBJ_TM1638_REFRESH
+#define GBJ_TM1638_REFRESH          1 // Rolling refresh of the controller
+#endif
+#ifndef GBJ_TM1638_IDLE
+#define GBJ_TM1638_IDLE             1 // Idle suspend after inactivity
+#endif
+#ifndef GBJ_TM1638_MIRROR
+#define GBJ_TM1638_MIRROR           1 // Export of changed display content
+#endif
+#ifndef GBJ_TM1638_SCHEDULER
+#define GBJ_TM1638_SCHEDULER        1 // Time budget, frame period, and chunked transmission
+#endif
+#ifndef GBJ_TM1638_BUS_TIMING
+#define GBJ_TM1638_BUS_TIMING       1 // Timing profiles of the bus
+#endif
+
+// Diagnostics
+#ifndef GBJ_TM1638_TRACE
+#define GBJ_TM1638_TRACE            0 // Bus transactions in trace, 0 for no tracing
+#endif
+
+// Features of a build compared by the method begin() besides the class size
+#define GBJ_TM1638_FEATURES ( \
+  (GBJ_TM1638_KEYPAD ? 0x01 : 0) | (GBJ_TM1638_PRINT ? 0x02 : 0) | \
+  (GBJ_TM1638_LEDS ? 0x04 : 0) | (GBJ_TM1638_ANIMATION ? 0x08 : 0) | \
+  (GBJ_TM1638_CONCURRENT ? 0x10 : 0) | (GBJ_TM1638_TRACE ? 0x20 : 0) | \
+  (GBJ_TM1638_ANODE ? 0x40 : 0) | (GBJ_TM1638_REFRESH ? 0x80 : 0) | \
+  (GBJ_TM1638_IDLE ? 0x100 : 0) | (GBJ_TM1638_MIRROR ? 0x200 : 0) | \
+  (GBJ_TM1638_SCHEDULER ? 0x400 : 0) | (GBJ_TM1638_BUS_TIMING ? 0x800 : 0))
 
 
 /*
@@ -77,7 +154,64 @@
 typedef void (*gbj_tm1638_handler)(uint8_t key, uint8_t action);
 
 
-class gbj_tm1638 : public Print
+/*
+  Custom type for instance aware callback functions (dispatcher) processing key
+  actions
+
+  DESCRIPTION:
+  The method is called then particular action with a key, for which it has been
+  registered, is detected. It receives the instance of the library, which has
+  detected the action, and the user context registered along with the method,
+  so that one procedure can serve multiple display modules.
+
+  PARAMETERS:
+  module - Pointer to the instance of the library detecting the action.
+           - Data type: gbj_tm1638*
+           - Default value: none
+           - Limited range: microcontroller's addressing range
+
+  key - Number of a keypad's key counting from 0, for which activity the handler
+        is called.
+        - Data type: non-negative integer
+        - Default value: none
+        - Limited range: 0 ~ 24
+
+  action - The action with a key, which has been executed recently.
+           - Data type: non-negative integer
+           - Default value: none
+           - Limited range: KEY_CLICK, KEY_CLICK_DOUBLE,
+                            KEY_HOLD, KEY_HOLD_DOUBLE
+
+  context - Pointer to user data registered with the handler.
+            - Data type: void*
+            - Default value: none
+            - Limited range: microcontroller's addressing range
+
+  RETURN: none
+*/
+class gbj_tm1638;
+typedef void (*gbj_tm1638_dispatcher)(gbj_tm1638* module, uint8_t key, uint8_t action, void* context);
+
+
+/*
+  Custom type for callback functions (animation) called periodically
+
+  DESCRIPTION:
+  The method is called by the method run() periodically, if the period has
+  elapsed and the time budget of that run allows it. It allows to update
+  the screen buffer for animations without blocking a sketch.
+
+  PARAMETERS: none
+
+  RETURN: none
+*/
+typedef void (*gbj_tm1638_animation)();
+
+
+class gbj_tm1638
+#if GBJ_TM1638_PRINT
+  : public Print
+#endif
 {
 public:
 
@@ -85,12 +219,36 @@ public:
 //------------------------------------------------------------------------------
 // Public constants
 //------------------------------------------------------------------------------
-static const String VERSION;
+static const char* const VERSION;
 enum ResultCodes
 {
   SUCCESS = 0,
   ERROR_PINS = 255, // Error defining pins, usually both are the same
   ERROR_ACK = 254, // Error at acknowledging a command
+  ERROR_TASK = 253, // Error at creating a task
+  ERROR_CONFIG = 252, // Error at different configuration of a sketch and the library
+};
+enum Orientations
+{
+  ORIENT_NORMAL = 0, // Display module in normal position
+  ORIENT_ROTATED = 1, // Display module upside down
+  ORIENT_MIRRORED = 2, // Display module watched in a mirror
+};
+enum Alignments
+{
+  ALIGN_LEFT = 0, // Text starts at the first digit of a field
+  ALIGN_RIGHT = 1, // Text ends at the last digit of a field
+};
+enum BusTimings
+{
+  BUS_FAST = 0, // No delays, bus speed given by a platform
+  BUS_DATASHEET = 1, // Minimal pulse widths by the datasheet
+  BUS_CABLE = 2, // Relaxed pulse widths for long wires
+};
+enum Easings
+{
+  EASE_LINEAR = 0, // Constant speed of fading
+  EASE_QUAD = 1, // Quadratic acceleration and deceleration of fading
 };
 enum KeyActions
 {
@@ -99,6 +257,13 @@ enum KeyActions
   KEY_HOLD = 3,
   KEY_HOLD_DOUBLE = 4,
 };
+enum KeyEchos
+{
+  ECHO_OFF = 0, // No key echo
+  ECHO_RED = 1, // Red LED of the same number as a pressed key
+  ECHO_GREEN = 2, // Green LED of the same number as a pressed key
+  ECHO_RADIX = 3, // Inverted radix of the digital tube of the same number
+};
 
 
 //------------------------------------------------------------------------------
@@ -168,13 +333,17 @@ gbj_tm1638(uint8_t pinClk = 2, uint8_t pinDio = 3, uint8_t pinStb = 4, \
   The method sets the microcontroller's pins dedicated for the driver and perfoms
   initial sequence recommended by the data sheet for the controller.
   - It clears the display and sets it to the normal operating mode.
+  - The method is compiled within a sketch, so that it passes the class size
+    and features seen by the sketch to the library, which fails with
+    ERROR_CONFIG without any other action, if they differ from its own ones,
+    i.e., configuration constants are defined in the sketch only.
 
   PARAMETERS: none
 
   RETURN:
   Result code.
 */
-uint8_t begin();
+inline uint8_t begin() { return beginConfig(sizeof(gbj_tm1638), GBJ_TM1638_FEATURES); }
 
 
 /*
@@ -184,6 +353,11 @@ uint8_t begin();
   The method transmits current content of the screen buffer to the driver, so that
   its content is displayed immediatelly and stays unchanged until another transmission.
   - The method utilizes automatic addressing mode of the driver.
+  - If the frame period is set, the method just marks the screen buffer as
+    pending for transmission like the method displayDefer() does. Then
+    the method run() transmits it at most once per frame period.
+  - The method displayNow() transmits the screen buffer immediatelly
+    regardless of the frame period.
 
   PARAMETERS: none
 
@@ -191,6 +365,30 @@ uint8_t begin();
   Result code.
 */
 uint8_t display();
+uint8_t displayNow();
+
+
+/*
+  Schedule transmission of screen buffer to driver
+
+  DESCRIPTION:
+  The method marks the screen buffer as pending for transmission, which is
+  performed by the method run() in chunks fitting its time budget.
+  - Repeated calling before the transmission has started has no effect.
+  - Calling during transmission causes next transmission after finishing the
+    current one.
+  - Without the scheduler feature the method run() transmits the screen buffer
+    entirely at once.
+
+  PARAMETERS: none
+
+  RETURN: none
+*/
+#if GBJ_TM1638_SCHEDULER
+inline void displayDefer() { frame_.pending = true; if (frame_.requested < 0xFFFFFFFF) frame_.requested++; }
+#else
+inline void displayDefer() { frame_.pending = true; }
+#endif
 
 
 /*
@@ -210,6 +408,182 @@ uint8_t displayOn();
 uint8_t displayOff();
 
 
+#if GBJ_TM1638_ANIMATION
+/*
+  Define blinking items of a display module
+
+  DESCRIPTION:
+  The particular method adds a digital tube or a LED to the blinking mask, which
+  is blinked after starting blinking by the method blinkStart().
+  - If there is no input digit or LED number provided, the method adds all
+    digital tubes or LEDs of a module at once.
+  - If the blinking mask contains all controlled digital tubes and LEDs, the
+    blinking is realized just by one byte display control commands like at
+    methods displayOff() and displayOn().
+  - Otherwise blinking items are turned off and on by fixed address writes
+    of just affected digital tubes and LEDs without changing the screen buffer.
+
+  PARAMETERS:
+  digit - Driver's digit tube number counting from 0, which should blink.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ 7
+
+  led - Driver's LED number counting from 0, which should blink.
+        - Data type: non-negative integer
+        - Default value: none
+        - Limited range: 0 ~ 7
+
+  RETURN: none
+*/
+inline void blinkDigit(uint8_t digit) { if (digit < status_.digits) blink_.mask |= 1 << addrGrid(digit); }
+inline void blinkDigit() { for (uint8_t digit = 0; digit < status_.digits; digit++) blinkDigit(digit); }
+#if GBJ_TM1638_LEDS
+inline void blinkLed(uint8_t led) { if (led < status_.leds) blink_.mask |= 1 << addrLed(led); }
+inline void blinkLed() { for (uint8_t led = 0; led < status_.leds; led++) blinkLed(led); }
+#endif
+
+
+/*
+  Start or stop blinking
+
+  DESCRIPTION:
+  The method blinkStart() starts blinking of items defined by the methods
+  blinkDigit() and blinkLed(), which is realized by the method run() at every
+  phase change. The method blinkStop() turns on all blinked items, stops
+  blinking, and clears the blinking mask.
+
+  PARAMETERS:
+  period - Duration of each blinking phase in milliseconds.
+           - Data type: non-negative integer
+           - Default value: 500
+           - Limited range: 0 ~ 65535
+
+  RETURN:
+  Result code.
+*/
+inline void blinkStart(uint16_t period = 500) { blink_.period = period; blink_.timestamp = millis(); blink_.active = true; }
+uint8_t blinkStop();
+
+
+/*
+  Fade display in or out, or pulse it
+
+  DESCRIPTION:
+  The methods start a transition of the contrast, which is realized by the
+  method run() without blocking a sketch.
+  - The method fadeIn() ramps the display from off up to the current contrast.
+  - The method fadeOut() ramps the display from the current contrast down to
+    off. The display stays off afterwards until the method displayOn() or
+    fadeIn() is called.
+  - The method fadePulse() ramps the display down and up again repeatedly
+    until the method fadeStop() is called, which turns the display on with
+    current contrast.
+  - The transition uses just one byte display control commands, which are sent
+    only when the output level changes.
+  - The fading should not be combined with blinking of the entire display,
+    because both control the display by the same command.
+
+  PARAMETERS:
+  duration - Duration of the transition or a half period of pulsing
+             in milliseconds.
+             - Data type: non-negative integer
+             - Default value: 1000
+             - Limited range: 0 ~ 65535
+
+  easing - Progress curve of the transition.
+           - Data type: non-negative integer
+           - Default value: EASE_LINEAR
+           - Limited range: EASE_LINEAR, EASE_QUAD
+
+  RETURN:
+  Result code at fadeStop(), none at others.
+*/
+inline void fadeIn(uint16_t duration = 1000, uint8_t easing = EASE_LINEAR) { fadeStart(0, status_.contrast + 1, duration, easing, false); }
+inline void fadeOut(uint16_t duration = 1000, uint8_t easing = EASE_LINEAR) { fadeStart(status_.contrast + 1, 0, duration, easing, false); }
+inline void fadePulse(uint16_t duration = 1000, uint8_t easing = EASE_LINEAR) { fadeStart(status_.contrast + 1, 0, duration, easing, true); }
+uint8_t fadeStop();
+#endif
+
+
+#if GBJ_TM1638_IDLE
+/*
+  Wake display module from idle suspend
+
+  DESCRIPTION:
+  The method ends the idle suspend set by the method setIdle() and restarts
+  the inactivity period, so that a sketch can report activity other than key
+  presses as well.
+  - The displayed screen buffer is transmitted entirely in one transfer and
+    then the display control at suspending is restored by one command, i.e.,
+    the display turned off by a sketch or by fading stays off. Display
+    control requested during suspend replaces the one at suspending.
+  - If the module is not suspended, the method just restarts the inactivity
+    period.
+  - A key press wakes the module automatically at keypad scanning and it is
+    processed as usual key action afterwards.
+
+  PARAMETERS: none
+
+  RETURN:
+  Result code.
+*/
+uint8_t idleWake();
+#endif
+
+
+/*
+  Select screen page for drawing
+
+  DESCRIPTION:
+  The method selects a screen page, which is manipulated by all print methods
+  as the screen buffer. Each page has its own printing position.
+  - A page can be drawn in the background, i.e., while another page is displayed.
+  - Pages are identified by numbers counting from 0, which can be named by an
+    enumeration in a sketch. The page 0 is drawn and displayed by default.
+  - The number of pages is defined by the constant GBJ_TM1638_PAGES.
+
+  PARAMETERS:
+  page - Number of a screen page counting from 0.
+         - Data type: non-negative integer
+         - Default value: none
+         - Limited range: 0 ~ GBJ_TM1638_PAGES - 1
+
+  RETURN: none
+*/
+void pageDraw(uint8_t page);
+
+
+/*
+  Display screen page
+
+  DESCRIPTION:
+  The method switches the displayed screen page and transmits it to the driver
+  by the method display().
+  - The switch is just a pointer change without any rendering, so that it is
+    instant.
+  - The method pageShow_P() displays a read only screen page defined in flash
+    memory as 16 bytes array of the controller's memory image, which does not
+    consume SRAM. Such page cannot be drawn.
+
+  PARAMETERS:
+  page - Number of a screen page counting from 0.
+         - Data type: non-negative integer
+         - Default value: none
+         - Limited range: 0 ~ GBJ_TM1638_PAGES - 1
+
+  frame - Pointer to 16 bytes array of a screen page in flash memory.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: microcontroller's addressing range
+
+  RETURN:
+  Result code.
+*/
+uint8_t pageShow(uint8_t page);
+uint8_t pageShow_P(const uint8_t* frame);
+
+
 /*
   Clear entire digital tubes including radixes and set printing position
 
@@ -245,7 +619,11 @@ inline void displayClear(uint8_t digit = 0) { printDigitOff(); printRadixOff();
 
   RETURN: none
 */
+#if GBJ_TM1638_LEDS
 inline void moduleClear(uint8_t digit = 0) { printLedOff(); displayClear(digit); }
+#else
+inline void moduleClear(uint8_t digit = 0) { displayClear(digit); }
+#endif
 
 
 /*
@@ -265,11 +643,11 @@ inline void moduleClear(uint8_t digit = 0) { printLedOff(); displayClear(digit);
 
   RETURN: none
 */
-inline void printRadixOn(uint8_t digit) { if (digit < status_.digits) print_.buffer[addrGrid(digit)] |= 0x80; }
+inline void printRadixOn(uint8_t digit) { if (digit < status_.digits) bufferSet(addrGrid(digit), print_.buffer[addrGrid(digit)] | 0x80); }
 inline void printRadixOn() { for (uint8_t digit = 0; digit < status_.digits; digit++) printRadixOn(digit); }
-inline void printRadixOff(uint8_t digit) { if (digit < status_.digits) print_.buffer[addrGrid(digit)] &= ~0x80; }
+inline void printRadixOff(uint8_t digit) { if (digit < status_.digits) bufferSet(addrGrid(digit), print_.buffer[addrGrid(digit)] & ~0x80); }
 inline void printRadixOff() { for (uint8_t digit = 0; digit < status_.digits; digit++) printRadixOff(digit); }
-inline void printRadixToggle(uint8_t digit) { if (digit < status_.digits) print_.buffer[addrGrid(digit)] ^= 0x80; }
+inline void printRadixToggle(uint8_t digit) { if (digit < status_.digits) bufferSet(addrGrid(digit), print_.buffer[addrGrid(digit)] ^ 0x80); }
 inline void printRadixToggle() { for (uint8_t digit = 0; digit < status_.digits; digit++) printRadixToggle(digit); }
 
 
@@ -323,12 +701,142 @@ inline void printDigitOff() { printDigit(0x00); }
 inline void placePrint(uint8_t digit = 0) { if (digit < status_.digits) print_.digit = digit; };
 
 
+#if GBJ_TM1638_PRINT
+#if GBJ_TM1638_FIELDS
+/*
+  Declare a field of digital tubes
+
+  DESCRIPTION:
+  The method declares a region of adjacent digital tubes, which is updated by
+  the method fieldPrint() independently from other fields and the printing
+  position.
+  - The number of fields is defined by the constant GBJ_TM1638_FIELDS.
+  - Declaring a field clears its hysteresis and decimation.
+
+  PARAMETERS:
+  field - Number of a field counting from 0.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ GBJ_TM1638_FIELDS - 1
+
+  digit - Number of the first digital tube of a field counting from 0.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ 7 (constructor's parameter digits - 1)
+
+  width - Number of digital tubes of a field. It is limited to the last digital
+          tube of a module.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 1 ~ 8 (constructor's parameter digits)
+
+  align - Alignment of a printed text within a field.
+          - Data type: non-negative integer
+          - Default value: ALIGN_RIGHT
+          - Limited range: ALIGN_LEFT, ALIGN_RIGHT
+
+  padding - Character filling digital tubes of a field not used by a text.
+            - Data type: char
+            - Default value: space
+            - Limited range: characters of the font
+
+  RETURN: none
+*/
+void fieldBegin(uint8_t field, uint8_t digit, uint8_t width, uint8_t align = ALIGN_RIGHT, char padding = ' ');
+
+
+/*
+  Suppress small or frequent changes of a field value
+
+  DESCRIPTION:
+  The method sets limits for printing numbers to a field, so that a jittery
+  value does not cause a transmission at every tiny change.
+  - A number differing from recently printed one less than the hysteresis is
+    not printed.
+  - A number is not printed earlier than the decimation period after recently
+    printed one.
+  - Texts are printed regardless of limits.
+
+  PARAMETERS:
+  field - Number of a field counting from 0.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ GBJ_TM1638_FIELDS - 1
+
+  hysteresis - Minimal change of a printed number.
+               - Data type: float
+               - Default value: 0
+               - Limited range: 0 ~ float maximum
+
+  period - Minimal time between printing numbers in milliseconds.
+           - Data type: non-negative integer
+           - Default value: 0
+           - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+void fieldLimit(uint8_t field, float hysteresis = 0, uint16_t period = 0);
+
+
+/*
+  Print text or number to a field
+
+  DESCRIPTION:
+  The method renders a text or a formatted number into digital tubes of
+  a declared field with its alignment and padding.
+  - Just digital tubes of the field are changed in the screen buffer and marked
+    for transmission and just if their segments have changed.
+  - The radixes of a field are controlled by the printed text only.
+  - A text longer than the field is cut off.
+  - Decimals of a number not fitting the field are rounded off. A number not
+    fitting the field even without decimals is displayed as dashes in all
+    digital tubes of the field.
+  - The printing position of the method placePrint() is not changed.
+
+  PARAMETERS:
+  field - Number of a field counting from 0.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ GBJ_TM1638_FIELDS - 1
+
+  text - Pointer to a null terminated string or String object.
+         - Data type: char pointer, String
+         - Default value: none
+         - Limited range: microcontroller's addressing range
+
+  value - Number to be printed.
+          - Data type: integer, float, double
+          - Default value: none
+          - Limited range: by data type
+
+  decimals - Number of decimal places of a printed float number.
+             - Data type: non-negative integer
+             - Default value: 1
+             - Limited range: 0 ~ 7
+
+  RETURN: none
+*/
+void fieldPrint(uint8_t field, const char* text);
+inline void fieldPrint(uint8_t field, String text) { fieldPrint(field, text.c_str()); };
+void fieldPrint(uint8_t field, long value);
+void fieldPrint(uint8_t field, unsigned long value);
+inline void fieldPrint(uint8_t field, int value) { fieldPrint(field, (long) value); };
+inline void fieldPrint(uint8_t field, unsigned int value) { fieldPrint(field, (unsigned long) value); };
+void fieldPrint(uint8_t field, float value, uint8_t decimals = 1);
+inline void fieldPrint(uint8_t field, double value, uint8_t decimals = 1) { fieldPrint(field, (float) value, decimals); };
+#endif
+
+
 /*
   Print text at desired printing position
 
   DESCRIPTION:
   The method prints text starting from provided or default position on digital tubes.
   - The method clears the display right before printing.
+  - The text is translated to segment masks of all digital tubes at first and
+    then only differing digital tubes are updated in the screen buffer, so that
+    the result is identical to clearing and printing, but reprinting the same
+    or similar text changes just a few digital tubes.
 
   PARAMETERS:
   text - Pointer to a text that should be printed.
@@ -343,8 +851,8 @@ inline void placePrint(uint8_t digit = 0) { if (digit < status_.digits) print_.d
 
   RETURN: none
 */
-inline void printText(const char* text, uint8_t digit = 0) { displayClear(digit); print(text); };
-inline void printText(String text, uint8_t digit = 0) { displayClear(digit); print(text); };
+inline void printText(const char* text, uint8_t digit = 0) { renderText((const uint8_t*) text, strlen(text), digit, false); };
+inline void printText(String text, uint8_t digit = 0) { renderText((const uint8_t*) text.c_str(), text.length(), digit, false); };
 
 
 /*
@@ -354,6 +862,7 @@ inline void printText(String text, uint8_t digit = 0) { displayClear(digit); pri
   The method prints text starting from provided or default position on digital
   tubes and leaves radixes intact.
   - The method clears only digit without radixes right before printing.
+  - The text is rendered the same way as at the method printText().
 
   PARAMETERS:
   text - Pointer to a text that should be printed.
@@ -368,8 +877,8 @@ inline void printText(String text, uint8_t digit = 0) { displayClear(digit); pri
 
   RETURN: none
 */
-inline void printGlyphs(const char* text, uint8_t digit = 0) { printDigitOff(); placePrint(digit); print(text); };
-inline void printGlyphs(String text, uint8_t digit = 0) { printDigitOff(); placePrint(digit); print(text); };
+inline void printGlyphs(const char* text, uint8_t digit = 0) { renderText((const uint8_t*) text, strlen(text), digit, true); };
+inline void printGlyphs(String text, uint8_t digit = 0) { renderText((const uint8_t*) text.c_str(), text.length(), digit, true); };
 
 
 /*
@@ -386,6 +895,8 @@ inline void printGlyphs(String text, uint8_t digit = 0) { printDigitOff(); place
     turns on the radix segments of the recently displayed digit (lastly manipulated
     digit). Thus, the decimal points or colon can be present in displayed string
     at proper position and does not need to be control separately.
+  - The methods for a string translate all characters to segment masks in one
+    pass including radixes and update the screen buffer at once.
 
   PARAMETERS:
   ascii - ASCII code of a character that should be displayed at the current digit
@@ -415,8 +926,10 @@ inline void printGlyphs(String text, uint8_t digit = 0) { printDigitOff(); place
 size_t write(uint8_t ascii);
 size_t write(const char* text);
 size_t write(const uint8_t* buffer, size_t size);
+#endif
 
 
+#if GBJ_TM1638_LEDS
 /*
   Manipulate LEDs of a display module
 
@@ -434,51 +947,344 @@ size_t write(const uint8_t* buffer, size_t size);
 
   RETURN: none
 */
-inline void printLedOnRed(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] = LED_RED; }
+inline void printLedOnRed(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), LED_RED); }
 inline void printLedOnRed() { for (uint8_t led = 0; led < status_.leds; led++) printLedOnRed(led); }
-inline void printLedToggleRed(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] &= ~LED_GREEN; print_.buffer[addrLed(led)] ^= LED_RED; }
+inline void printLedToggleRed(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), (print_.buffer[addrLed(led)] & ~LED_GREEN) ^ LED_RED); }
 inline void printLedToggleRed() { for (uint8_t led = 0; led < status_.leds; led++) printLedToggleRed(led); }
 //
-inline void printLedOnGreen(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] = LED_GREEN; }
+inline void printLedOnGreen(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), LED_GREEN); }
 inline void printLedOnGreen() { for (uint8_t led = 0; led < status_.leds; led++) printLedOnGreen(led); }
-inline void printLedToggleGreen(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] &= ~LED_RED; print_.buffer[addrLed(led)] ^= LED_GREEN; }
+inline void printLedToggleGreen(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), (print_.buffer[addrLed(led)] & ~LED_RED) ^ LED_GREEN); }
 inline void printLedToggleGreen() { for (uint8_t led = 0; led < status_.leds; led++) printLedToggleGreen(led); }
 //
-inline void printLedOff(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] = LED_OFF; }
+inline void printLedOff(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), LED_OFF); }
 inline void printLedOff() { for (uint8_t led = 0; led < status_.leds; led++) printLedOff(led); }
-inline void printLedSwap(uint8_t led) { if (led < status_.leds) print_.buffer[addrLed(led)] = ~print_.buffer[addrLed(led)]; }
+inline void printLedSwap(uint8_t led) { if (led < status_.leds) bufferSet(addrLed(led), ~print_.buffer[addrLed(led)]); }
 inline void printLedSwap() { for (uint8_t led = 0; led < status_.leds; led++) printLedSwap(led); }
 
 
+/*
+  Display level meter on LEDs
+
+  DESCRIPTION:
+  The method displays a level as a bar graph of LEDs starting from the LED 0 and
+  transmits it immediatelly.
+  - Only LEDs changed since the recent level are updated in the screen buffer
+    and transmitted by fixed address writes, so that a level update costs just
+    a few bytes on the bus.
+  - If the peak holding is set by the method setLedBarPeak(), the LED of the
+    recent peak level stays lit during the hold time and then the peak decays
+    by one LED per decay period, which is evaluated at every level update.
+
+  PARAMETERS:
+  level - Number of lit LEDs.
+          - Data type: non-negative integer
+          - Default value: none
+          - Limited range: 0 ~ 8 (constructor's parameter leds)
+
+  colorZones - Bit mask of LEDs colors, where bit 0 relates to the LED 0.
+               The set bit means red color, the reset bit green color.
+               - Data type: non-negative integer
+               - Default value: 0xFF (all red)
+               - Limited range: 0 ~ 255
+
+  RETURN:
+  Result code.
+*/
+uint8_t printLedBar(uint8_t level, uint8_t colorZones = 0xFF);
+#endif
+
+
+#if GBJ_TM1638_KEYPAD
 /*
   Register handler procedure for key action processing
 
   DESCRIPTION:
   The method registers a procedure, which is called when particular action with a key of module's keypad has been performed.
+  - An instance aware handler is registered with a user context into the
+    dispatch list either for particular key and action, or for all of them
+    at once, which replaces all recent registrations. The list has
+    GBJ_TM1638_DISPATCHERS entries and a registration not fitting it is
+    ignored. If the constant is 0, only the plain handler is available.
+  - A key action is dispatched to the handler registered for its key and
+    action, otherwise to the one registered for all keys, otherwise to
+    the plain handler.
+  - Registering the NULL handler for a key and action removes that
+    registration, so that the key action is processed by the plain handler.
+  - Registering the NULL plain handler, e.g., registerHandler(NULL),
+    unregisters the plain handler.
 
   PARAMETERS:
   handler - Pointer to a handler procedure.
-            - Data type: gbj_tm1638_handler
+            - Data type: gbj_tm1638_handler, gbj_tm1638_dispatcher
             - Default value: none
             - Limited range: microcontroller's addressing range
 
+  key - Number of a keypad's key counting from 0, for which the handler should
+        be called.
+        - Data type: non-negative integer
+        - Default value: none
+        - Limited range: 0 ~ GBJ_TM1638_KEYS_PRESENT - 1
+
+  action - The action with a key, for which the handler should be called.
+           - Data type: non-negative integer
+           - Default value: none
+           - Limited range: KEY_CLICK, KEY_CLICK_DOUBLE,
+                            KEY_HOLD, KEY_HOLD_DOUBLE
+
+  context - Pointer to user data passed to the handler. It is mandatory for
+            all keys, so that a NULL handler is not ambiguous.
+            - Data type: void*
+            - Default value: NULL for a key and action, none for all keys
+            - Limited range: microcontroller's addressing range
+
   RETURN: none
 */
 void registerHandler(gbj_tm1638_handler handler);
+#if GBJ_TM1638_DISPATCHERS
+void registerHandler(gbj_tm1638_dispatcher handler, void* context);
+void registerHandler(uint8_t key, uint8_t action, gbj_tm1638_dispatcher handler, void* context = NULL);
+#endif
 
 
 /*
-  Evaluate timing and process keys of a module's keypad
+  Read currently pressed keys
 
   DESCRIPTION:
-  The method processes timing and catches keypad's keys presses and calls a handler if particular action is detected.
-  - The method should be call very often. The best place is in the loop() function of a sketch, which should be without delay() function or other blocking activities.
+  The particular method returns a bit mask of currently pressed keys, where
+  the bit 0 corresponds to the key 0.
+  - The method readKeys() reads the keypad in one fixed cost bus transaction
+    and caches the result.
+  - The method readKeysCached() returns the key mask of the recent keypad
+    reading without communication with the controller, i.e., from the recent
+    readKeys() call or keypad scanning in the method run().
+  - The method readKeysChanged() returns the mask of keys changed in the recent
+    keypad reading since the previous call of this method.
+  - The methods do not process any key actions, so that a sketch needing just
+    pressed keys can bypass the key actions detection entirely.
 
   PARAMETERS: none
 
+  RETURN:
+  Bit mask of pressed or changed keys.
+*/
+uint32_t readKeys();
+inline uint32_t readKeysCached() { return scan_.keys; }
+inline uint32_t readKeysChanged() { uint32_t changed = scan_.keys ^ scan_.keysRead; scan_.keysRead = scan_.keys; return changed; }
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+/*
+  Register animation procedure called periodically
+
+  DESCRIPTION:
+  The method registers a procedure, which is called by the method run() every
+  time the period has elapsed.
+
+  PARAMETERS:
+  animation - Pointer to an animation procedure.
+              - Data type: gbj_tm1638_animation
+              - Default value: none
+              - Limited range: microcontroller's addressing range
+
+  period - Time period in milliseconds between calls of the procedure.
+           - Data type: non-negative integer
+           - Default value: none
+           - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+void registerAnimation(gbj_tm1638_animation animation, uint16_t period);
+#endif
+
+
+/*
+  Evaluate timing and run scheduled tasks within time budget
+
+  DESCRIPTION:
+  The method acts as a cooperative scheduler. It processes timing and catches
+  keypad's keys presses and calls a handler if particular action is detected,
+  transmits pending screen buffer, and calls a registered animation procedure.
+  - The method should be call very often. The best place is in the loop() function of a sketch, which should be without delay() function or other blocking activities.
+  - A task is postponed to the next run, if its recently measured duration does
+    not fit the rest of the time budget. The task that does not fit the entire
+    budget is run only as the first one in a run.
+  - A pending screen buffer is transmitted in chunks with as many bytes as
+    fits the rest of the time budget. The very first chunk is a sole byte,
+    which measures the duration of a byte for sizing next chunks.
+  - If a run exceeds the time budget, it is counted as an overrun.
+  - Without the scheduler feature the time budget is ignored, all due tasks
+    are run, and a pending screen buffer is transmitted entirely at once.
+
+  PARAMETERS:
+  budget - Time budget of a run in microseconds.
+           - Data type: non-negative integer
+           - Default value: 0 (no limit)
+           - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+void run(uint16_t budget = 0);
+
+
+#if GBJ_TM1638_KEYPAD && GBJ_TM1638_LATENCY_BINS
+/*
+  Reset key action latency histogram
+
+  DESCRIPTION:
+  The method clears all bins of the histogram of latencies between a key press
+  and calling the handler for all key actions.
+
+  PARAMETERS: none
+
+  RETURN: none
+*/
+void resetKeyLatency();
+#endif
+
+
+#if GBJ_TM1638_CONCURRENT
+/*
+  Start sharing screen between tasks
+
+  DESCRIPTION:
+  The method switches the library to the concurrency mode, where one task
+  (drawer) draws the screen buffer and publishes it, while another task
+  (renderer) calls the method run(), which takes recently published screen
+  buffer and transmits it.
+  - The drawer uses just print methods and the method publish(). It must not
+    call methods communicating with the driver.
+  - The renderer calls the method run() and other methods communicating with
+    the driver. Key handlers are called in the renderer task as well.
+  - The screen buffer is published with a sequence lock, so that the drawer is
+    never blocked, and the renderer never transmits a torn screen buffer. If
+    the renderer meets the publishing in progress, it just postpones taking
+    the screen buffer to the next run.
+  - The method should be called before starting the tasks.
+
+  PARAMETERS: none
+
+  RETURN: none
+*/
+void shareBegin();
+
+
+/*
+  Publish screen buffer for renderer
+
+  DESCRIPTION:
+  The method copies the drawn screen buffer to the shared one, which the method
+  run() takes and transmits in the renderer task.
+  - The method never blocks and should be called by just one drawer task.
+
+  PARAMETERS: none
+
+  RETURN: none
+*/
+void publish();
+
+
+#if defined(ESP32)
+/*
+  Start dedicated refresh and scanning task
+
+  DESCRIPTION:
+  The method creates a FreeRTOS task, which calls the method run() with the
+  time budget periodically, so that it acts as the renderer of the shared
+  screen and scans the keypad.
+
+  PARAMETERS:
+  period - Time period in milliseconds between runs.
+           - Data type: non-negative integer
+           - Default value: 1
+           - Limited range: 1 ~ 65535
+
+  budget - Time budget of a run in microseconds.
+           - Data type: non-negative integer
+           - Default value: 0 (no limit)
+           - Limited range: 0 ~ 65535
+
+  priority - Priority of the task.
+             - Data type: non-negative integer
+             - Default value: 1
+             - Limited range: 0 ~ configMAX_PRIORITIES - 1
+
+  core - Processor core running the task.
+         - Data type: integer
+         - Default value: tskNO_AFFINITY
+         - Limited range: 0, 1, tskNO_AFFINITY
+
+  RETURN:
+  Result code.
+*/
+uint8_t taskBegin(uint16_t period = 1, uint16_t budget = 0, uint8_t priority = 1, int core = tskNO_AFFINITY);
+#endif
+#endif
+
+
+#if GBJ_TM1638_TRACE
+/*
+  Dump and clear trace of bus transactions
+
+  DESCRIPTION:
+  The method writes recorded bus transactions to a stream starting from
+  the oldest one, one transaction per line in the text format
+  "T <timestamp> <duration> <command> <payload>", where the timestamp and
+  duration are decimal numbers in microseconds, while the command and payload
+  bytes are hexadecimal numbers.
+  - The trace is a ring buffer with GBJ_TM1638_TRACE recent transactions.
+  - Payload of reading transaction is the data received from the controller.
+  - The tracing is compiled in only if the constant GBJ_TM1638_TRACE is defined
+    with positive number of transactions.
+  - The dump can be replayed on a host by the decoder in the folder extras.
+
+  PARAMETERS:
+  out - Stream, usually a serial port, for writing trace into.
+        - Data type: Print
+        - Default value: none
+        - Limited range: reference to an object
+
   RETURN: none
 */
-void run();
+void traceDump(Print &out);
+inline void traceClear() { trace_.head = trace_.count = 0; }
+#endif
+
+
+#if GBJ_TM1638_MIRROR
+/*
+  Export changes of displayed screen buffer for mirroring
+
+  DESCRIPTION:
+  The method writes addresses of the displayed screen buffer changed since
+  recent export to a stream as a compact binary update, so that a remote
+  mirror of the display costs a few bytes per change.
+  - An update consists of records terminated by the byte 0xFF. A record is
+    the header byte with the start address in the upper nibble and the number
+    of following data bytes minus one in the lower nibble, followed by data
+    bytes of that span of addresses.
+  - Changed addresses separated by one unchanged address are joined to one
+    record, because it costs the same number of bytes.
+  - Data bytes are in the layout of the screen buffer, i.e., digital tubes at
+    even and LEDs at odd addresses regardless of orientation and wiring.
+  - Nothing is written if there is no change.
+  - The method mirrorReset() marks all addresses changed, so that the next
+    export contains entire screen buffer, e.g., for a new mirror.
+  - The stream can be decoded on a host by the decoder in the folder extras.
+
+  PARAMETERS:
+  out - Stream, usually a serial port, for writing update into.
+        - Data type: Print
+        - Default value: none
+        - Limited range: reference to an object
+
+  RETURN:
+  Number of written bytes.
+*/
+size_t mirrorExport(Print &out);
+inline void mirrorReset() { mirror_.dirty = 0xFFFF; }
+#endif
 
 
 //------------------------------------------------------------------------------
@@ -506,6 +1312,273 @@ inline uint8_t setLastResult(uint8_t lastResult = SUCCESS) { return status_.last
 uint8_t setContrast(uint8_t contrast = 3);
 
 
+#if GBJ_TM1638_SCHEDULER
+/*
+  Set frame period for coalescing transmissions
+
+  DESCRIPTION:
+  The method sets the minimal time period between starts of screen buffer
+  transmissions by the method run(), while the method display() just marks
+  the screen buffer as pending for transmission.
+  - Multiple calls of the method display() within a frame period are coalesced
+    to one transmission.
+  - The first transmission is started at once, the period applies from it.
+  - The period 17 ms corresponds to about 60 frames per second.
+
+  PARAMETERS:
+  period - Frame period in milliseconds.
+           - Data type: non-negative integer
+           - Default value: 0 (no coalescing, immediate transmissions)
+           - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+inline void setFramePeriod(uint16_t period = 0) { frame_.period = period; }
+#endif
+
+
+#if GBJ_TM1638_LEDS
+/*
+  Set peak holding of level meter on LEDs
+
+  DESCRIPTION:
+  The method sets the time of holding a peak level and the period of its decay
+  for the method printLedBar().
+
+  PARAMETERS:
+  hold - Time in milliseconds of holding a peak level.
+         - Data type: non-negative integer
+         - Default value: 0
+         - Limited range: 0 ~ 65535
+
+  decay - Time period in milliseconds of decreasing a peak level by one LED.
+          - Data type: non-negative integer
+          - Default value: 0 (no peak holding)
+          - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+inline void setLedBarPeak(uint16_t hold = 0, uint16_t decay = 0) { bar_.hold = hold; bar_.decay = decay; bar_.peak = 0; }
+#endif
+
+
+#if GBJ_TM1638_KEYPAD
+/*
+  Enable or disable key actions processing
+
+  DESCRIPTION:
+  The method enables or disables detecting key actions and calling the handler
+  at keypad scanning in the method run(). If the processing is disabled, the
+  method run() just scans the keypad for the method readKeysCached().
+
+  PARAMETERS:
+  enable - Flag about processing key actions.
+           - Data type: boolean
+           - Default value: true
+           - Limited range: true, false
+
+  RETURN: none
+*/
+inline void setKeyActions(bool enable = true) { scan_.actions = enable; }
+
+
+/*
+  Set echo of pressed keys
+
+  DESCRIPTION:
+  The method sets immediate visual acknowledgment of pressed keys without
+  waiting for key action detection.
+  - A press of a key lights the LED or inverts the radix of the digital tube
+    with the same number as the key, right at the keypad scanning, which has
+    detected it. The release of a key restores the LED or the radix.
+  - The echo is an overlay of transmitted data, so that the screen buffer is
+    not changed by it. Just the echoed address is transmitted by fixed address
+    write at every press and release.
+  - Keys without corresponding LED or digital tube are not echoed.
+  - Key actions are detected and processed as usual.
+
+  PARAMETERS:
+  mode - Type of key echo.
+         - Data type: non-negative integer
+         - Default value: ECHO_RED
+         - Limited range: ECHO_OFF, ECHO_RED, ECHO_GREEN, ECHO_RADIX
+
+  RETURN:
+  Result code.
+*/
+uint8_t setKeyEcho(uint8_t mode = ECHO_RED);
+#endif
+
+
+#if GBJ_TM1638_BUS_TIMING
+/*
+  Set timing profile of the bus
+
+  DESCRIPTION:
+  The method selects the profile with durations of clock pulse high and low
+  levels and strobe setup time, which are enforced at every bit and
+  transaction on the bus.
+  - The fast profile adds no delays, so that the bus speed is given by the speed
+    of pin manipulation on a platform. It is the default profile.
+  - The datasheet profile keeps pulse widths at least 1 microsecond, which
+    satisfies the minimal timing of the controller on fast platforms.
+  - The cable profile slows the bus down to about 100 kbit/s for long wires
+    between a microcontroller and a display module.
+
+  PARAMETERS:
+  profile - Timing profile of the bus.
+            - Data type: non-negative integer
+            - Default value: BUS_DATASHEET
+            - Limited range: BUS_FAST, BUS_DATASHEET, BUS_CABLE
+
+  RETURN: none
+*/
+void setBusTiming(uint8_t profile = BUS_DATASHEET);
+#endif
+
+
+#if GBJ_TM1638_ANIMATION
+/*
+  Enable or disable modulation of fading levels
+
+  DESCRIPTION:
+  The method enables or disables alternating adjacent contrast levels at every
+  fading step in the ratio of the fractional part of the output level, which
+  makes transitions between the 8 hardware contrast levels smoother.
+
+  PARAMETERS:
+  enable - Flag about modulation of fading levels.
+           - Data type: boolean
+           - Default value: true
+           - Limited range: true, false
+
+  RETURN: none
+*/
+inline void setFadeDither(bool enable = true) { fade_.dither = enable; }
+#endif
+
+
+#if GBJ_TM1638_REFRESH
+/*
+  Set rolling refresh of the display
+
+  DESCRIPTION:
+  The method enables the rolling refresh, which recovers the controller's memory
+  and settings corrupted by electromagnetic interference without periodic
+  transmission of entire screen buffer.
+  - The method run() resends few addresses of the displayed screen buffer at
+    fixed addressing in round-robin order at every refresh step, so that the
+    cost of a step is small and constant. Each step reasserts the data command
+    as well.
+  - After all addresses the step reasserts recent display control command,
+    i.e., display state and contrast.
+  - Steps are spread evenly within the refresh window, which is the time of
+    refreshing entire display.
+  - A step is skipped, if the screen buffer is pending or being transmitted
+    or it does not fit the time budget of a run.
+  - A step resends only transmitted content, i.e., addresses changed since
+    recent display are skipped.
+
+  PARAMETERS:
+  window - Time of refreshing entire display in milliseconds.
+           - Data type: non-negative integer
+           - Default value: 1000
+           - Limited range: 0 ~ 65535 (0 turns off the rolling refresh)
+
+  RETURN: none
+*/
+void setRefresh(uint16_t window = 1000);
+#endif
+
+
+#if GBJ_TM1638_IDLE
+/*
+  Set idle suspend of the display module
+
+  DESCRIPTION:
+  The method enables the idle manager, which suspends the display module after
+  the inactivity period without key presses.
+  - At suspending the method run() turns the display off once, stops fading,
+    and skips transmissions of the screen buffer, rolling refresh, blinking,
+    and animation, so that only the keypad is scanned at the slow scan period.
+  - Transmissions and display control commands requested during suspend are
+    postponed, i.e., changes of screen buffer, contrast, and display state are
+    kept and displayed at waking.
+  - A key press or the method idleWake() wakes the module.
+
+  PARAMETERS:
+  timeout - Inactivity period in seconds.
+            - Data type: non-negative integer
+            - Default value: 0
+            - Limited range: 0 ~ 65535 (0 turns off the idle suspend)
+
+  scan - Keypad scanning period in milliseconds during suspend.
+         - Data type: non-negative integer
+         - Default value: 250
+         - Limited range: 0 ~ 65535
+
+  RETURN: none
+*/
+void setIdle(uint16_t timeout = 0, uint16_t scan = 250);
+#endif
+
+
+/*
+  Set orientation of a display module
+
+  DESCRIPTION:
+  The method sets the mounting orientation of a display module, which is
+  applied at transmitting the screen buffer to the driver, so that drawing
+  methods and fonts work the same at all orientations.
+  - At rotated and mirrored orientation the order of digital tubes and LEDs is
+    reversed and segments of each digit are remapped by a lookup table in flash
+    memory, while radixes remain at their digits.
+  - The method marks entire screen buffer for transmission, so that it should
+    be followed by the method display().
+
+  PARAMETERS:
+  orientation - Orientation of a display module.
+                - Data type: non-negative integer
+                - Default value: ORIENT_NORMAL
+                - Limited range: ORIENT_NORMAL, ORIENT_ROTATED, ORIENT_MIRRORED
+
+  RETURN: none
+*/
+inline void setOrientation(uint8_t orientation = ORIENT_NORMAL) { status_.orientation = min(orientation, (uint8_t) ORIENT_MIRRORED); print_.dirty = 0xFFFF; }
+
+
+#if GBJ_TM1638_ANODE
+/*
+  Set common anode wiring of a display module
+
+  DESCRIPTION:
+  The method switches the library to display modules with common anode digital
+  tubes, e.g., QYF-TM1638 boards, where controller's grids drive segments and
+  segment lines drive digital tubes.
+  - The screen buffer and all drawing methods keep the layout of the common
+    cathode modules. The digital tubes part of the screen buffer is transposed
+    as a bit matrix 8 x 8 at transmission to the controller, if some digital
+    tube has changed.
+  - The keypad is scanned in the layout of those boards with 16 keys, where
+    keys 0 ~ 7 are on the line K1 and keys 8 ~ 15 on the line K2 in pairs
+    of each scanned byte. The constant GBJ_TM1638_KEYS_PRESENT should be
+    defined to 16 for them.
+  - The method marks entire screen buffer for transmission, so that it should
+    be followed by the method display().
+
+  PARAMETERS:
+  enable - Flag about common anode wiring.
+           - Data type: boolean
+           - Default value: true
+           - Limited range: true, false
+
+  RETURN: none
+*/
+inline void setCommonAnode(bool enable = true) { status_.anode = enable; anode_.valid = false; print_.dirty = 0xFFFF; }
+#endif
+
+
+#if GBJ_TM1638_PRINT
 /*
   Define font parameters for printing
 
@@ -538,6 +1611,7 @@ uint8_t setContrast(uint8_t contrast = 3);
   RETURN: none
 */
 void setFont(const uint8_t* fontTable, uint8_t fontTableSize);
+#endif
 
 
 //------------------------------------------------------------------------------
@@ -554,7 +1628,108 @@ inline uint8_t getKeysMax() { return KEYS; } // Maximal supported keys
 inline uint8_t getKeysMaxHw() { return GBJ_TM1638_KEYS_PRESENT; } // Hardware supported keys
 inline uint8_t getContrast() { return status_.contrast; } // Current contrast
 inline uint8_t getContrastMax() { return 7; } // Maximal contrast
+#if GBJ_TM1638_BUS_TIMING
+inline uint8_t getBusTiming() { return bus_.profile; } // Timing profile of the bus
+#endif
+#if GBJ_TM1638_REFRESH
+inline uint16_t getRefresh() { return refresh_.window; } // Time of rolling refresh of entire display
+#endif
+#if GBJ_TM1638_IDLE
+inline uint16_t getIdle() { return idle_.timeout; } // Inactivity period in seconds before idle suspend
+#endif
+#if GBJ_TM1638_ANODE
+inline bool isCommonAnode() { return status_.anode; } // Flag about common anode wiring
+#endif
+inline uint8_t getOrientation() { return status_.orientation; } // Current orientation
 inline uint8_t getPrint() { return print_.digit; } // Current digit position
+#if GBJ_TM1638_SCHEDULER
+inline uint16_t getRunOverruns() { return run_.overruns; } // Number of runs exceeding time budget
+inline uint16_t getRunOverrunMax() { return run_.overrunMax; } // Maximal time budget excess in microseconds
+inline uint16_t getFramePeriod() { return frame_.period; } // Frame period of coalescing
+inline uint32_t getFramesRequested() { return frame_.requested; } // Number of requested transmissions
+inline uint32_t getFramesSent() { return frame_.sent; } // Number of finished transmissions
+#endif
+inline uint8_t getPages() { return GBJ_TM1638_PAGES; } // Number of screen pages
+inline uint8_t getPageDraw() { return page_.draw; } // Drawn screen page
+inline uint8_t getPageShow() { return page_.show; } // Displayed screen page, GBJ_TM1638_PAGES for flash page, next one for shared
+#if GBJ_TM1638_CONCURRENT
+inline uint32_t getShareRetries() { return share_.retries; } // Postponed takings of shared screen
+#endif
+#if GBJ_TM1638_ANIMATION
+inline bool isBlinking() { return blink_.active; } // Flag about running blinking
+inline bool isFading() { return fade_.active; } // Flag about running fading
+#endif
+#if GBJ_TM1638_IDLE
+inline bool isIdle() { return idle_.active; } // Flag about idle suspend
+#endif
+#if GBJ_TM1638_SCHEDULER
+inline bool isDisplayPending() { return frame_.pending || frame_.active; } // Flag about pending transmission
+#else
+inline bool isDisplayPending() { return frame_.pending; } // Flag about pending transmission
+#endif
+#if GBJ_TM1638_KEYPAD
+inline bool isKeyActions() { return scan_.actions; } // Flag about processing key actions
+inline uint8_t getKeyEcho() { return echo_.mode; } // Type of key echo
+#endif
+#if GBJ_TM1638_KEYPAD && GBJ_TM1638_LATENCY_BINS
+inline uint8_t getKeyLatencyBins() { return GBJ_TM1638_LATENCY_BINS; } // Bins of latency histogram
+inline uint16_t getKeyLatencyWidth() { return TIMING_SCAN; } // Latency histogram bin width in milliseconds
+
+
+/*
+  Get timestamps of recent key action
+
+  DESCRIPTION:
+  The particular method returns a timestamp in milliseconds of the recent key
+  action phase.
+  - The press timestamp is the time of the scan that detected the first press
+    of the recent key action, i.e., of the first click at double actions.
+  - The action timestamp is the time of the scan that detected the key action
+    right before the handler has been called.
+  - Both timestamps are valid within the handler of the action, so that their
+    difference is the latency of the action detection.
+
+  PARAMETERS:
+  key - Number of a keypad's key counting from 0.
+        - Data type: non-negative integer
+        - Default value: none
+        - Limited range: 0 ~ 7 (constructor's parameter keys - 1)
+
+  RETURN:
+  Timestamp in milliseconds or 0 for not controlled key.
+*/
+inline uint32_t getKeyTimePress(uint8_t key) { return key < status_.keys ? keys_[key].pressTimestamp : 0; }
+inline uint32_t getKeyTimeAction(uint8_t key) { return key < status_.keys ? keys_[key].actionTimestamp : 0; }
+
+
+/*
+  Get bin of key action latency histogram
+
+  DESCRIPTION:
+  The method returns the number of key actions of particular type, which latency
+  between the key press and calling the handler has fallen to a histogram bin.
+  - A bin covers the latency range with width of keypad scanning period, i.e.,
+    the bin n counts latencies from n to n + 1 scanning periods.
+  - The last bin counts all longer latencies as well.
+  - A bin counter saturates at its maximal value.
+
+  PARAMETERS:
+  action - The key action.
+           - Data type: non-negative integer
+           - Default value: none
+           - Limited range: KEY_CLICK, KEY_CLICK_DOUBLE,
+                            KEY_HOLD, KEY_HOLD_DOUBLE
+
+  bin - Number of a histogram bin counting from 0.
+        - Data type: non-negative integer
+        - Default value: none
+        - Limited range: 0 ~ GBJ_TM1638_LATENCY_BINS - 1
+
+  RETURN:
+  Number of key actions in the bin or 0 for wrong input parameters.
+*/
+uint16_t getKeyLatency(uint8_t action, uint8_t bin);
+#endif
 inline bool isSuccess() { return status_.lastResult == SUCCESS; } // Flag about successful recent operation
 inline bool isError() { return !isSuccess(); } // Flag about erroneous recent operation
 
@@ -587,11 +1762,12 @@ enum Geometry // Controller TM1638
   KEYS = 8, // Default keys in the keypad
   BYTES_ADDR = 16, // By datasheet maximal addressable register positions
   BYTES_SCAN = 4, // By datasheet maximal key press detection bytes
+  BYTES_REFRESH = 2, // Addresses refreshed in one rolling refresh step
 };
 enum Timing
 {
-  TIMING_RELAX = 2, // MCU relaxing delay in microseconds after pin change
   TIMING_SCAN = 100, // Keypad scanning interval in milliseconds
+  TIMING_FADE = 1, // Fading step interval in milliseconds
   TIMING_SCAN_TRESHOLD_WAIT = 2, // Number of scans for long key release duration
   TIMING_SCAN_TRESHOLD_PRESS_LONG = 5, // Number of scans for long key press duration
 };
@@ -622,13 +1798,27 @@ enum KEYs
 struct
 {
   uint8_t buffer[BYTES_ADDR];  // Screen buffer
+  uint8_t digit; // Printing position of a page
+} pages_[GBJ_TM1638_PAGES]; // Screen pages
+struct
+{
+  uint8_t draw; // Drawn screen page
+  uint8_t show; // Displayed screen page
+  const uint8_t* frame; // Displayed screen buffer in SRAM or flash
+} page_; // Screen pages selection
+struct
+{
+  uint8_t* buffer;  // Screen buffer of drawn page
   uint8_t digit; // Current digit for next printing
+  uint16_t dirty; // Displayed screen buffer addresses changed since transmission
 } print_; // Display hardware parameters for printing
+#if GBJ_TM1638_PRINT
 struct Bitmap
 {
   const uint8_t* table; // Pointer to a font table
   uint8_t glyphs; // Number of glyphs in the font table
 } font_;  // Font parameters
+#endif
 struct
 {
   uint8_t lastResult; // Result of a recent operation
@@ -640,17 +1830,219 @@ struct
   uint8_t leds; // Amount of controlled LEDs
   uint8_t keys; // Amount of controlled keys
   uint8_t contrast; // Current contrast level
+  uint8_t control; // Recently sent display control command
+  uint8_t orientation; // Orientation of a display module
+#if GBJ_TM1638_ANODE
+  bool anode; // Flag about common anode wiring
+#endif
+  uint16_t addrs; // Bit mask of controlled screen buffer addresses
   uint32_t scanTimestamp; // Recent keypad scanning time
 } status_;  // Microcontroller status features
+#if GBJ_TM1638_KEYPAD
 struct
 {
   uint8_t pressScans;  // Number of continuous scanning at pressed key
   uint8_t waitScans;  // Number of continuous scanning at released key
   uint8_t keyState[5]; // Key state history
+#if GBJ_TM1638_LATENCY_BINS
+  uint32_t pressTimestamp; // Scan time of the first press of an action
+  uint32_t actionTimestamp; // Scan time of a recent action detection
+#endif
 } keys_[GBJ_TM1638_KEYS_PRESENT]; // Display module key records list
+#if GBJ_TM1638_LATENCY_BINS
+uint16_t latency_[KEY_HOLD_DOUBLE][GBJ_TM1638_LATENCY_BINS]; // Histogram of key action latencies
+#endif
+
+struct
+{
+  uint32_t keys; // Pressed keys at recent keypad reading
+  uint32_t keysRead; // Pressed keys at recent reading of changed keys
+  bool actions; // Flag about processing key actions
+  uint16_t cost; // Duration of recent keypad scanning in microseconds
+} scan_; // Keypad reading
+struct
+{
+  uint8_t mode; // Type of key echo
+  uint16_t mask; // Screen buffer addresses with echo overlay
+  uint32_t keys; // Pressed keys at recent echo
+} echo_; // Key echo
+#endif
+struct
+{
+  bool pending; // Flag about screen buffer waiting for transmission
+#if GBJ_TM1638_SCHEDULER
+  bool active; // Flag about transmission in progress
+  uint8_t addr; // Next address of screen buffer to be transmitted
+  bool started; // Flag about a transmission started, so that the period applies
+  uint16_t period; // Minimal period between transmissions in milliseconds
+  uint32_t timestamp; // Recent transmission start time
+  uint32_t requested; // Number of requested transmissions
+  uint32_t sent; // Number of finished transmissions
+  uint16_t cost; // Duration of transmitting a byte in microseconds
+#endif
+} frame_; // Deferred transmission of screen buffer
+#if GBJ_TM1638_SCHEDULER
+struct
+{
+  uint16_t budget; // Time budget of current run in microseconds
+  uint32_t start; // Start time of current run in microseconds
+  bool busy; // Flag about a task run in current run
+  uint16_t overruns; // Number of runs exceeding time budget
+  uint16_t overrunMax; // Maximal time budget excess in microseconds
+} run_; // Scheduler parameters
+#endif
+#if GBJ_TM1638_ANIMATION
+struct
+{
+  gbj_tm1638_animation handler; // Animation procedure
+  uint16_t period; // Animation period in milliseconds
+  uint32_t timestamp; // Recent animation time
+  uint16_t cost; // Duration of recent animation in microseconds
+} animation_; // Periodic animation
+#endif
+
+#if GBJ_TM1638_CONCURRENT
+struct
+{
+  bool active; // Flag about concurrency mode
+  uint32_t seq; // Sequence number of publishing, odd during publishing
+  uint32_t taken; // Sequence number of recently taken screen buffer
+  uint32_t retries; // Number of postponed takings
+  uint8_t frame[BYTES_ADDR]; // Published screen buffer
+  uint8_t snapshot[BYTES_ADDR]; // Taken screen buffer for transmission
+#if defined(ESP32)
+  uint16_t period; // Period of task runs in milliseconds
+  uint16_t budget; // Time budget of task runs in microseconds
+#endif
+} share_; // Shared screen
+#endif
+#if GBJ_TM1638_TRACE
+struct
+{
+  struct
+  {
+    uint32_t timestamp; // Start of transaction in microseconds
+    uint16_t duration; // Duration of transaction in microseconds
+    uint8_t command; // Command byte
+    uint8_t bytes; // Number of payload bytes
+    uint8_t payload[BYTES_ADDR]; // Sent or received data
+  } entries[GBJ_TM1638_TRACE]; // Ring buffer of transactions
+  uint8_t head; // Index of next recorded transaction
+  uint8_t count; // Number of recorded transactions
+} trace_; // Trace of bus transactions
+#endif
+
+#if GBJ_TM1638_LEDS
+struct
+{
+  uint8_t peak; // Peak level
+  uint16_t hold; // Time of holding peak level in milliseconds
+  uint16_t decay; // Period of peak level decay in milliseconds
+  uint32_t timestamp; // Recent peak level change time
+} bar_; // Level meter on LEDs
+#endif
+#if GBJ_TM1638_ANIMATION
+struct
+{
+  bool active; // Flag about running blinking
+  bool off; // Flag about off phase of blinking
+  uint16_t mask; // Screen buffer addresses of blinking items
+  uint16_t period; // Duration of a blinking phase in milliseconds
+  uint32_t timestamp; // Recent phase change time
+  uint16_t cost; // Duration of recent phase change in microseconds
+} blink_; // Blinking manager
+#endif
+#if GBJ_TM1638_BUS_TIMING
+struct
+{
+  uint8_t profile; // Timing profile
+  uint8_t clkHigh; // Duration of clock high level in microseconds
+  uint8_t clkLow; // Duration of clock low level in microseconds
+  uint8_t strobe; // Strobe setup time in microseconds
+} bus_; // Bus timing
+#endif
+#if GBJ_TM1638_ANIMATION
+struct
+{
+  bool active; // Flag about running fading
+  bool pulse; // Flag about repeated fading
+  bool dither; // Flag about modulation between adjacent levels
+  uint8_t easing; // Progress curve
+  uint8_t from; // Starting output level, 0 for off, 1 ~ 8 for contrast 0 ~ 7
+  uint8_t to; // Final output level
+  uint8_t sent; // Recently sent output level
+  uint8_t error; // Accumulated fraction of level for modulation
+  uint16_t duration; // Duration of a transition in milliseconds
+  uint32_t start; // Start time of a transition
+  uint32_t timestamp; // Recent step time
+  uint16_t cost; // Duration of recent step in microseconds
+} fade_; // Contrast fading
+#endif
+#if GBJ_TM1638_REFRESH
+struct
+{
+  uint16_t window; // Time of refreshing entire display in milliseconds
+  uint8_t addr; // Next controller's address to be refreshed
+  uint32_t timestamp; // Recent step time
+  uint16_t cost; // Duration of recent step in microseconds
+} refresh_; // Rolling refresh
+#endif
+#if GBJ_TM1638_IDLE
+struct
+{
+  bool active; // Flag about idle suspend
+  uint8_t control; // Display control command restored at waking
+  uint16_t timeout; // Inactivity period in seconds
+  uint16_t scan; // Keypad scanning period during suspend in milliseconds
+  uint32_t timestamp; // Recent activity time
+} idle_; // Idle manager
+#endif
+#if GBJ_TM1638_ANODE
+struct
+{
+  bool valid; // Flag about computed segment rows
+  uint16_t marked; // Screen buffer addresses of segment rows marked for transmission
+  uint8_t rows[DIGITS]; // Transposed digital tubes, segment per byte
+} anode_; // Common anode wiring
+#endif
+#if GBJ_TM1638_MIRROR
+struct
+{
+  uint16_t dirty; // Displayed screen buffer addresses changed since export
+} mirror_; // Mirroring of display
+#endif
+#if GBJ_TM1638_PRINT && GBJ_TM1638_FIELDS
+struct
+{
+  uint8_t digit; // First digital tube
+  uint8_t width; // Number of digital tubes
+  uint8_t align; // Alignment of text
+  char padding; // Character for unused digital tubes
+  bool printed; // Flag about printed number
+  float value; // Recently printed number
+  float hysteresis; // Minimal change of printed number
+  uint16_t period; // Minimal time between printed numbers in milliseconds
+  uint32_t timestamp; // Recent time of printed number
+} fields_[GBJ_TM1638_FIELDS]; // Screen fields
+#endif
 
+#if GBJ_TM1638_KEYPAD
 // Pointers to global (default) alarm handlers
 gbj_tm1638_handler keyProcesing_;
+#if GBJ_TM1638_DISPATCHERS
+struct
+{
+  struct
+  {
+    uint8_t key; // Key of registration
+    uint8_t action; // Key action of registration, 0 for all keys and actions
+    gbj_tm1638_dispatcher handler; // Instance aware handler, NULL for plain one
+    void* context; // User context of the handler
+  } entries[GBJ_TM1638_DISPATCHERS];
+  uint8_t count; // Number of registrations
+} dispatch_; // Instance aware handlers
+#endif
+#endif
 
 
 //------------------------------------------------------------------------------
@@ -660,18 +2052,113 @@ inline void swapByte(uint8_t a, uint8_t b) { if (a > b) {uint8_t t = a; a = b; b
 inline uint8_t addrGrid(uint8_t digit) { return 2 * digit; }
 inline uint8_t addrLed(uint8_t led) { return 2 * led + 1; }
 inline uint8_t setLastCommand(uint8_t lastCommand) { return status_.lastCommand = lastCommand; }
-void waitPulseClk();  // Delay for clock pulse duration
+inline void bufferSet(uint8_t addr, uint8_t data) { if (print_.buffer[addr] != data) { print_.buffer[addr] = data; if (page_.show == page_.draw) { print_.dirty |= 1 << addr; mirrorMark(1 << addr); } } }
+#if GBJ_TM1638_MIRROR
+inline void mirrorMark(uint16_t mask) { mirror_.dirty |= mask; } // Mark displayed addresses changed for export
+#else
+inline void mirrorMark(uint16_t) {}
+#endif
+#if GBJ_TM1638_IDLE
+inline bool idleActive() { return idle_.active; } // Flag about suspended transmissions
+#else
+inline bool idleActive() { return false; }
+#endif
+inline uint8_t screenByte(uint8_t addr) { return page_.show == getPages() ? pgm_read_byte(&page_.frame[addr]) : page_.frame[addr]; } // Displayed screen buffer byte in SRAM or flash
+#if GBJ_TM1638_ANODE
+inline uint8_t frameBytes() { return status_.anode ? max(2 * DIGITS - 1, max(status_.digits, status_.leds) * 2) : max(status_.digits, status_.leds) * 2 - (status_.digits > status_.leds ? 1 : 0); }
+#else
+inline uint8_t frameBytes() { return max(status_.digits, status_.leds) * 2 - (status_.digits > status_.leds ? 1 : 0); }
+#endif
+#if GBJ_TM1638_REFRESH
+inline uint16_t refreshPeriod() { return max(refresh_.window / ((frameBytes() + BYTES_REFRESH - 1) / BYTES_REFRESH + 1), 1); } // Steps for current frame addresses and one for display control
+#endif
+uint8_t beginConfig(size_t size, uint16_t features); // Check configuration seen by a sketch and initialize display
+#if GBJ_TM1638_SCHEDULER
+inline uint32_t runStart() { return micros(); } // Start time of a task
+bool runFits(uint16_t cost); // Check if a task fits the rest of time budget
+void runTask(uint16_t &cost, uint32_t tsStart); // Measure task duration
+void runDisplay(); // Transmit chunk of pending screen buffer
+#else
+inline uint32_t runStart() { return 0; }
+inline bool runFits(uint16_t) { return true; }
+inline void runTask(uint16_t &, uint32_t) {}
+#endif
+#if GBJ_TM1638_REFRESH
+uint8_t runRefresh(); // Make rolling refresh step
+#endif
+#if GBJ_TM1638_IDLE
+uint8_t idleSuspend(); // Turn display off and suspend transmissions
+#endif
+#if GBJ_TM1638_ANIMATION
+uint8_t runBlink(); // Change blinking phase
+uint8_t runFade(); // Make fading step
+void fadeStart(uint8_t from, uint8_t to, uint16_t duration, uint8_t easing, bool pulse); // Start fading between output levels
+uint8_t fadeSend(uint8_t level); // Send changed output level by display control
+#endif
+inline uint16_t addrMask() { return status_.addrs; } // Bit mask of controlled screen buffer addresses
+uint8_t frameAddr(uint8_t addr); // Screen buffer address for controller's address and vice versa
+uint8_t frameByte(uint8_t addr); // Screen buffer byte for transmission to controller's address
+uint8_t frameSource(uint8_t addr); // Screen buffer byte at controller's address in common cathode layout
+#if GBJ_TM1638_ANODE
+uint16_t anodeUpdate(bool force); // Transpose digital tubes to segment rows and mark changed ones
+uint16_t anodeMask(uint16_t mask); // Screen buffer addresses for fixed addressing in common anode wiring
+void bitTranspose(const uint8_t* in, uint8_t* out); // Transpose bit matrix 8 x 8
+#else
+inline uint16_t anodeMask(uint16_t mask) { return mask; }
+#endif
+inline bool isDirty(uint8_t addr) { return print_.dirty & (1 << frameAddr(addr)); } // Changed controller's address
+#if GBJ_TM1638_BUS_TIMING
+inline void waitStrobe() { waitPulse(bus_.strobe); } // Delay for strobe setup time
+inline void waitClkLow() { waitPulse(bus_.clkLow); } // Delay for clock low level
+inline void waitClkHigh() { waitPulse(bus_.clkHigh); } // Delay for clock high level
+inline void waitPulse(uint8_t duration) { if (duration) delayMicroseconds(duration); } // Delay for pulse duration
+#else
+inline void waitStrobe() {}
+inline void waitClkLow() {}
+inline void waitClkHigh() {}
+#endif
 void gridWrite(uint8_t segmentMask = 0x00, uint8_t gridStart = 0, uint8_t gridStop = DIGITS); // Fill screen buffer with digit masks
 void beginTransmission(); // Start condition
 void endTransmission(); // Stop condition
 void busWrite(uint8_t data);  // Write byte to the bus
+#if GBJ_TM1638_KEYPAD
 uint8_t busRead();  // Read byte from the bus
 uint8_t busReceive(uint8_t command, uint8_t* buffer);
+#endif
 uint8_t busSend(uint8_t command); // Send sole command
 uint8_t busSend(uint8_t command, uint8_t data); // Send data at fixed address
 uint8_t busSend(uint8_t command, uint8_t* buffer, uint8_t bufferBytes); // Send data at auto-increment addressing
+uint8_t busSendFrame(uint8_t addr, uint8_t bytes); // Send part of screen buffer at auto-increment addressing
+uint8_t busSendFixed(uint16_t mask); // Send screen buffer addresses at fixed addressing
+#if GBJ_TM1638_PRINT
 uint8_t getFontMask(uint8_t ascii); // Lookup font mask in font table by ASCII code
+uint8_t textMasks(const uint8_t* text, size_t size, uint8_t* masks, uint8_t &digit, uint8_t digits); // Translate text to segment masks from position
+#if GBJ_TM1638_FIELDS
+bool fieldChanged(uint8_t field, float value); // Check hysteresis and decimation of field number
+void fieldNumber(uint8_t field, unsigned long magnitude, bool negative, uint8_t decimals); // Print fixed point number to field
+#endif
+void renderText(const uint8_t* text, size_t size, uint8_t digit, bool keepRadix); // Print text with updating changed digits only
+#endif
+#if GBJ_TM1638_CONCURRENT
+void shareTake(); // Take published screen buffer
+#if defined(ESP32)
+static void taskRun(void* instance); // Body of refresh task
+#endif
+#endif
+#if GBJ_TM1638_TRACE
+void traceRecord(uint32_t tsStart, uint8_t command, const uint8_t* payload, uint8_t bytes); // Record transaction
+#endif
+#if GBJ_TM1638_KEYPAD
 uint8_t processKeypad(); // Process keypad scanning
+uint8_t processEcho(uint32_t keyMask); // Transmit echo of changed keys
+#if GBJ_TM1638_LATENCY_BINS
+void processLatency(uint8_t key, uint8_t action); // Record action latency to histogram
+#endif
+void processAction(uint8_t key, uint8_t action); // Call handler of key action
+#if GBJ_TM1638_DISPATCHERS
+uint8_t dispatchFind(uint8_t key, uint8_t action); // Index of registration or number of them if missing
+#endif
+#endif
 };
 
 #endif